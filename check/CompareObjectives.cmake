@@ -0,0 +1,78 @@
+#
+# runs StaticAmbulanceVRP twice on the same instance, with COMMON_ARGS and ARGS_A, then with COMMON_ARGS and ARGS_B,
+# and fails unless the objectives of both runs (solution cost, 7th column of the .out files) are within TOLERANCE.
+#
+# cmake -DBINARY=<StaticAmbulanceVRP> -DCOMMON_ARGS="..." -DARGS_A="..." -DARGS_B="..." -DWORK_DIR=<dir> [-DTOLERANCE=1] -P CompareObjectives.cmake
+# arguments are space separated, as on a command line
+#
+cmake_policy(SET CMP0007 NEW) # empty columns are columns too
+
+if(NOT DEFINED TOLERANCE)
+    # Params::RCEpsilon
+    set(TOLERANCE 1)
+endif()
+
+#
+# rounds a number of the .out files (scientific notation, e.g. 1.2345e+03) to an integer, since CMake's math() has no floating point
+#
+function(round_to_integer number out)
+    if(NOT number MATCHES "^(-?)([0-9]+)\\.?([0-9]*)e([+-][0-9]+)$")
+        message(FATAL_ERROR "not a finite number: ${number}")
+    endif()
+    set(sign ${CMAKE_MATCH_1})
+    set(digits "${CMAKE_MATCH_2}${CMAKE_MATCH_3}")
+    string(LENGTH "${CMAKE_MATCH_2}" integer_length)
+    math(EXPR point "${integer_length} + ${CMAKE_MATCH_4}")
+    string(LENGTH "${digits}" nb_digits)
+
+    if(point LESS 0)
+        set(rounded 0)
+    elseif(point GREATER_EQUAL nb_digits)
+        math(EXPR zeros "${point} - ${nb_digits}")
+        string(REPEAT "0" ${zeros} padding)
+        set(rounded "${digits}${padding}")
+    else()
+        string(SUBSTRING "${digits}" 0 ${point} rounded)
+        string(SUBSTRING "${digits}" ${point} 1 first_dropped)
+        if(rounded STREQUAL "")
+            set(rounded 0)
+        endif()
+        if(first_dropped GREATER_EQUAL 5)
+            math(EXPR rounded "${rounded} + 1")
+        endif()
+    endif()
+    math(EXPR rounded "${sign}${rounded}")
+    set(${out} ${rounded} PARENT_SCOPE)
+endfunction()
+
+file(REMOVE_RECURSE "${WORK_DIR}")
+file(MAKE_DIRECTORY "${WORK_DIR}")
+separate_arguments(common_args UNIX_COMMAND "${COMMON_ARGS}")
+
+foreach(run A B)
+    separate_arguments(run_args UNIX_COMMAND "${ARGS_${run}}")
+    execute_process(COMMAND "${BINARY}" ${common_args} ${run_args} --output_dir "${WORK_DIR}" --output_suffix "_${run}"
+                    RESULT_VARIABLE result
+                    OUTPUT_FILE "${WORK_DIR}/${run}.log"
+                    ERROR_FILE "${WORK_DIR}/${run}.log")
+    file(GLOB out_file "${WORK_DIR}/*_${run}.out")
+    list(LENGTH out_file nb_out_files)
+    if(NOT result EQUAL 0 OR NOT nb_out_files EQUAL 1)
+        message(FATAL_ERROR "run ${run} (${ARGS_${run}}) failed, see ${WORK_DIR}/${run}.log")
+    endif()
+
+    file(STRINGS "${out_file}" lines)
+    list(GET lines -1 line)
+    string(REPLACE "," ";" columns "${line}")
+    list(GET columns 6 objective_${run})
+    round_to_integer(${objective_${run}} rounded_${run})
+endforeach()
+
+math(EXPR difference "${rounded_A} - ${rounded_B}")
+if(difference LESS 0)
+    math(EXPR difference "-${difference}")
+endif()
+if(difference GREATER TOLERANCE)
+    message(FATAL_ERROR "objectives differ: ${objective_A} (${ARGS_A}) and ${objective_B} (${ARGS_B})")
+endif()
+message(STATUS "objectives: ${objective_A} (${ARGS_A}) and ${objective_B} (${ARGS_B})")
@@ -1,11 +1,12 @@
 #pragma once
 
 #include <utility>
-#include <set>
-#include <map>
+#include <vector>
+#include <cstdint>
+#include <cmath>
 
 using std::pair;
-using std::map;
+using std::vector;
 
 #include "ProblemData.h"
 #include "ProblemSolution.h"
@@ -23,12 +24,61 @@ struct PricingReturn
 	size_t labelsStored;
 	size_t maxLabelsStoredSimultaneously;
 	size_t labelsDeleted;
+	size_t labelsPrunedByBound; //expansions discarded because they could not reach a negative reduced cost
 	size_t mostLabelsInRequest;
 	size_t nbConsideredRequests;
 	bool timeout;
+	bool exitedEarly; //labeling stopped once enough columns were below BasePricing::SetEarlyExitReducedCost
+	bool incremental; //columns came from re-costing the labels of a previous call, without labeling
+	size_t labelsReused; //labels of a previous call re-costed
 	vector<double> reducedCostPerRoute;
 };
 
+/*
+	edge branching information for a pricing call, indexed by request *index* (see ProblemData::RequestIdToIndex)
+		- forbidden request-to-request connections, as a bit matrix
+		- duals of the edge branching constraints, as a dense matrix. Only allocated if there is some edge dual
+
+	both are symmetric. Built once per node in DoPricing and shared, read-only, by every pricing call
+*/
+class PricingEdges
+{
+	int nbRequests;
+	vector<uint64_t> forbidden; // nbRequests rows of rowWords words each
+	int rowWords;
+	vector<double> duals; // nbRequests x nbRequests, empty if no edge duals
+
+public:
+	explicit PricingEdges(int nbRequests) : nbRequests(nbRequests), rowWords((nbRequests + 63) / 64)
+	{
+		forbidden.assign((size_t) nbRequests * rowWords, 0);
+	}
+
+	void Forbid(int iReq1, int iReq2)
+	{
+		forbidden[(size_t) iReq1 * rowWords + iReq2 / 64] |= uint64_t(1) << (iReq2 % 64);
+		forbidden[(size_t) iReq2 * rowWords + iReq1 / 64] |= uint64_t(1) << (iReq1 % 64);
+	}
+
+	void SetDual(int iReq1, int iReq2, double dual)
+	{
+		if(duals.empty()) duals.assign((size_t) nbRequests * nbRequests, 0.0);
+		duals[(size_t) iReq1 * nbRequests + iReq2] = dual;
+		duals[(size_t) iReq2 * nbRequests + iReq1] = dual;
+	}
+
+	bool IsForbidden(int iReq1, int iReq2) const
+	{
+		return (forbidden[(size_t) iReq1 * rowWords + iReq2 / 64] >> (iReq2 % 64)) & 1;
+	}
+
+	// 0.0 if the edge has no branching constraint
+	double Dual(int iReq1, int iReq2) const
+	{
+		return duals.empty() ? 0.0 : duals[(size_t) iReq1 * nbRequests + iReq2];
+	}
+};
+
 class BasePricing
 {
 protected:
@@ -36,10 +86,29 @@ protected:
 
 	double max_time;
 	int max_memory; // in MB
+	double earlyExitReducedCost;
+	bool exactReducedCosts;
+
+	/*
+		labels within this much of a better one are dominated. A dominated label may be up to that much better at each later step,
+		so it is 0 when reduced costs must be exact
+	*/
+	double DominanceEpsilon() const { return exactReducedCosts ? 0.0 : params->RCEpsilon; }
 public:
 
 	void SetMaxTime(double max_time){this->max_time = max_time;}
 	void SetMaxMemory(int max_memory){this->max_memory = max_memory;}
+	//labeling may stop as soon as n_routes columns have reduced cost below this. -HUGE_VAL -> never. Algorithms that always run to the end ignore it
+	void SetEarlyExitReducedCost(double reducedCost){this->earlyExitReducedCost = reducedCost;}
+	//the most negative reduced cost must be exact, for Lagrangian bounds: no incremental pricing, completion bound pruning nor epsilon dominance
+	void SetExactReducedCosts(bool value){this->exactReducedCosts = value;}
+
+	//heuristic pricing may miss negative reduced cost routes. Algorithms without a heuristic mode ignore it
+	virtual void SetHeuristicPricing(bool /*value*/){}
+	//keep at most maxLabels labels per request, which is also heuristic. 0 -> no limit
+	virtual void SetLabelLimit(int /*maxLabels*/){}
+	//do SetHeuristicPricing and SetLabelLimit change anything?
+	virtual bool HasHeuristicModes() const { return false; }
 
 	ProblemData* problemData;
 
@@ -47,6 +116,8 @@ public:
 	{
 		max_time = 1.0e+20;
 		max_memory = 1000;
+		earlyExitReducedCost = -HUGE_VAL;
+		exactReducedCosts = false;
 	};
 
 	//pure virtual function:
@@ -54,7 +125,7 @@ public:
 	// beta duals are the duals requestConstraints in MIP Solver (nbRequests total)
 	// n_routes indicates how many new routes we want: the algorithm may return less routes if there aren't enough feasible negative reduced cost routes
 	// returns true if routes with negative reduced cost were found
-	virtual PricingReturn Price(int vehicle_id, int n_routes, vector<double>& alpha_duals, vector<double>& beta_duals, vector<Route>& outRoutes, vector<int> consideredRequests, set<pair<int, int>> forbiddenEdges, map<pair<int, int>, double> edgeDuals) = 0;
+	virtual PricingReturn Price(int vehicle_id, int n_routes, vector<double>& alpha_duals, vector<double>& beta_duals, vector<Route>& outRoutes, vector<int> consideredRequests, const PricingEdges& edges) = 0;
 
 	PricingReturn Price(int vehicle_id, int n_routes, vector<double>& alpha_duals, vector<double>& beta_duals, vector<Route>& outRoutes)
 	{
@@ -64,9 +135,8 @@ public:
 		{
 			consideredRequests.push_back(problemData->IndexToRequestId(i));
 		}
-		set<pair<int, int>> forbiddenEdges;
-		map<pair<int, int>, double> edgeDuals;
-		return Price(vehicle_id, n_routes, alpha_duals, beta_duals, outRoutes, consideredRequests, forbiddenEdges, edgeDuals);
+		PricingEdges edges(problemData->NbRequests());
+		return Price(vehicle_id, n_routes, alpha_duals, beta_duals, outRoutes, consideredRequests, edges);
 	}
 
 
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <vector>
+#include <chrono>
+
+#include "ProblemData.h"
+#include "ProblemSolution.h"
+#include "BasePricing.h"
+#include "PricingArena.h"
+#include "LabelSettingPricing.h"
+
+class TransitionTable;
+
+using std::vector;
+
+/*
+	bidirectional pricing, meeting at a time midpoint tm (Params::bidirectionalMidpoint of the vehicle's remaining horizon)
+
+	every route splits at its first request reached after tm:
+		- forward labels start at the vehicle's initial position, as in LabelSettingPricing, and are only expanded while their time is <= tm
+		- backward labels grow from the last request of a route towards earlier requests, and only cover requests reached after tm
+		- whenever a forward expansion reaches a request after tm, it is joined with the backward labels of that request
+
+	lateness depends on the arrival time, so a backward label can't hold a single reduced cost:
+	it holds the reduced cost of its suffix as a piecewise linear function of the arrival time at its first request, built from the TransitionTable.
+	A backward label is dominated by another one of the same request with a better function (see DominanceEpsilon) over its whole domain
+
+	transitions must be tabulated for every time: without a TransitionTable, or with rerouting, pricing is left to a LabelSettingPricing.
+	There is no heuristic mode
+*/
+class BidirectionalPricing final : public BasePricing
+{
+	struct Piece
+	{
+		double start; //holds from start up to the start of the next piece
+		double value; //at start. HUGE_VAL if infeasible
+		double slope;
+	};
+
+	// piecewise linear function over [pieces[0].start, end]
+	struct Function
+	{
+		const Piece* pieces;
+		int nbPieces;
+		double end;
+	};
+
+	struct ForwardLabel
+	{
+		int reqIndex; //index in consideredRequests
+		double reducedCost;
+		double time;
+		int lastWaitingStation; //-1 if no waiting station was visited between lastLabel and this
+		IntermediateVertex* intermediatePosition;
+		const ForwardLabel* lastLabel;
+	};
+
+	struct BackwardLabel
+	{
+		int reqIndex; //index in consideredRequests
+		Function reducedCost; //of the suffix starting at reqIndex, by arrival time at reqIndex. Includes its lateness and beta dual
+		const BackwardLabel* nextLabel; //NULL if the route ends here
+		bool dominated;
+	};
+
+	// a route: forward part, up to forward (the initial position if NULL), then the suffix of backward (nothing if NULL)
+	struct Column
+	{
+		const ForwardLabel* forward;
+		const BackwardLabel* backward;
+		double joinTime; //arrival time at the first request of backward
+		double reducedCost;
+	};
+
+	struct CompForwardOrder
+	{
+		bool operator()(const ForwardLabel* l1, const ForwardLabel* l2) const
+		{
+			if(l1->time != l2->time) return l1->time > l2->time;
+			return l1->reducedCost > l2->reducedCost;
+		}
+	};
+
+	static bool compLRC(const Column &c1, const Column &c2) { return c1.reducedCost < c2.reducedCost; }
+
+	static double Evaluate(const Function &f, double t);
+
+	// appends the piece starts and the end of f that are in [lo, hi]
+	static void AppendBreakpoints(const Function &f, double lo, double hi, vector<double> &out);
+
+	static const Piece& PieceAt(const Function &f, double t);
+
+	// does a hold values better than b (see DominanceEpsilon) over the whole domain of b?
+	bool Dominates(const Function &a, const Function &b);
+
+	// where the lateness of consideredRequests[j] may jump (target wait time objective)
+	void LatenessBreakpoints(int j, vector<double> &out);
+
+	/*
+		builds a piecewise linear function on [lo, hi] from the exact evaluation f, linear between consecutive breakpoints.
+		Returns false if f is infeasible everywhere. The pieces of out are only valid until the next call, see Store
+	*/
+	template <class F>
+	bool BuildFunction(F f, vector<double> &breakpoints, double lo, double hi, Function &out);
+
+	// copies the pieces of f into the arena
+	Function Store(const Function &f);
+
+	// arrival time at consideredRequests[k] when leaving consideredRequests[j] at time t. Built once per pair and call
+	const Function& ArrivalFunction(int j, int k);
+
+	PricingReturn pricing_ret;
+
+	// owns labels, intermediate positions and function pieces of a Price call
+	PricingArena arena;
+
+	// problem state of the current Price call
+	int vehicle_id;
+	double midpoint;
+	const TransitionTable* transitionTable;
+	vector<const Request*> requests;
+	vector<int> requestIndices;
+	vector<double> beta; //by considered request
+
+	vector<Function> arrivalFunctions; //nbConsidered x nbConsidered
+	vector<bool> arrivalFunctionBuilt;
+
+	vector<vector<BackwardLabel*>> backwardLabels; //per considered request
+
+	//scratch buffers
+	vector<Piece> scratchPieces;
+	vector<double> arrivalBreakpoints;
+
+	// best reduced cost of the forward labels already expanded at each considered request
+	vector<double> bestExpandedRC;
+	vector<const ForwardLabel*> queue; //heap ordered by CompForwardOrder
+
+	size_t n_desired_routes;
+	vector<Column> bestColumnsHeap;
+	bool TryAddToBestColumnsHeap(const Column &column);
+
+	//returns false if the time or memory limits were hit
+	bool CheckLimits(std::chrono::steady_clock::time_point alg_start);
+
+	bool BackwardLabeling(const PricingEdges& edges, std::chrono::steady_clock::time_point alg_start);
+
+	//joins a forward expansion that reached consideredRequests[j] at time, after the midpoint, with the backward labels there
+	void Join(const ForwardLabel* forward, int j, double time, double reducedCost);
+
+	//returns true if label was queued for expansion
+	bool TryAddForwardLabel(const ForwardLabel &label);
+
+	bool ForwardLabeling(double alpha_dual, const PricingEdges& edges, std::chrono::steady_clock::time_point alg_start);
+
+	bool BuildRoute(const Column &column, Route &outRoute);
+
+	void Cleanup();
+
+	// used when transitions can't be tabulated
+	LabelSettingPricing fallback;
+
+public:
+	BidirectionalPricing(Params *params, ProblemData* problemData);
+	~BidirectionalPricing(){}
+
+	PricingReturn Price(int vehicle_id, int n_routes, vector<double>& alpha_duals, vector<double>& beta_duals, vector<Route>& outRoutes, vector<int> consideredRequests, const PricingEdges& edges);
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+using std::vector;
+using std::string;
+
+//one call of a scenario. Integer columns are kept as doubles, as in the files
+struct Call
+{
+	double time;
+	double regionIndex;
+	double priority;
+	double day;
+	double timeOnScene;
+	double lat;
+	double lon;
+	double timeAtHospital;
+	double timeCleaningBase;
+	double cleaningNeeded;
+	double hospitalNeeded;
+	double indexHospital;
+	double indexCleaning;
+};
+
+/*
+	memory mapped calls file of Vincent's instances: scenarios one after the other, each a line with its number of calls and then a line per call,
+	in the 13 columns format or in the 10 columns one (see Scenario)
+
+	scenarios are found through an index of their byte offsets, so reading one doesn't read the ones before it.
+	The index is built on first use and stored next to the file, in "<path>.index", for later runs. It is rebuilt whenever the file's size or
+	modification time change. If it can't be stored, a warning is printed and the index only lives in memory
+*/
+class CallFile
+{
+	string path;
+	std::shared_ptr<const void> mapping; //the whole file
+	size_t size;
+	int64_t modificationTime[2]; //seconds, nanoseconds
+
+	vector<uint64_t> offsets; //of each scenario's first line
+	bool complete; //false if the index stopped at a malformed scenario
+
+	bool LoadIndex();
+	void BuildIndex();
+	void StoreIndex() const;
+
+public:
+	//throws std::invalid_argument if the file can't be opened
+	explicit CallFile(string path);
+
+	//same as the constructor, but files already opened by this process are shared, unless they changed since. Thread safe
+	static std::shared_ptr<const CallFile> Open(string path);
+
+	//scenarios up to the first malformed one
+	int NbScenarios() const { return offsets.size(); }
+	//true if every scenario in the file is well formed
+	bool IsComplete() const { return complete; }
+
+	/*
+		calls of scenario index, in [0, NbScenarios()). Throws std::invalid_argument if a line can't be read
+		the 10 columns format has no region index, day or cleaning base index: those are 0
+	*/
+	vector<Call> Scenario(int index, bool tenColumns) const;
+};
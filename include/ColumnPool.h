@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+
+#include "ProblemData.h"
+#include "ProblemSolution.h"
+#include "BasePricing.h"
+
+using std::vector;
+using std::pair;
+
+/*
+	routes priced at some point but not turned into variables, re-priced with the duals of each pricing round before labeling
+
+	variables in SCIP are re-priced by SCIP itself (problem variable pricing), so the pool keeps the priced routes that didn't get a variable:
+	mostly copies of a vehicle class representative's routes, skipped because their reduced cost was not negative for that member yet,
+	and routes priced again while already a variable, which SCIP may remove later as they are removable
+
+	entries are kept in parallel arrays, and the requests of all entries in a single one, so Scan is a tight loop over contiguous memory.
+	An entry is evicted after maxAge rounds without negative reduced cost, and the least recently useful ones when the pool is full
+*/
+class ColumnPool
+{
+	size_t maxSize;
+	int maxAge;
+
+	vector<Route> routes;
+	vector<int> vehicles;
+	vector<double> costs;
+	vector<int> requestsBegin; //requests of entry e are requests[requestsBegin[e], requestsBegin[e + 1]), in visiting order
+	vector<int> requests; //request indices
+	vector<int> ages; //rounds since the entry last had negative reduced cost. Taken entries are past maxAge
+
+	// drops taken entries, entries past maxAge, and the oldest ones beyond keep
+	void Compact(size_t keep);
+
+public:
+	ColumnPool(size_t maxSize, int maxAge) : maxSize(maxSize), maxAge(maxAge)
+	{
+		requestsBegin.push_back(0);
+	}
+
+	size_t Size() const { return costs.size(); }
+
+	void Add(ProblemData* problemData, const Route& route);
+
+	/*
+		appends (reduced cost, entry) to out for every entry with reduced cost below -rcEpsilon, skipping those using a forbidden edge.
+		Ages the other entries. Entries are valid until the next Add or Scan
+	*/
+	void Scan(const vector<double>& alpha_duals, const vector<double>& beta_duals, const PricingEdges& edges, double rcEpsilon, vector<pair<double, int>>& out);
+
+	const Route& GetRoute(int entry) const { return routes[entry]; }
+
+	// entry became a variable, it leaves the pool at the next Scan
+	void Take(int entry) { ages[entry] = maxAge + 1; }
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <assert.h>
+
+#include "ProblemData.h"
+#include "BasePricing.h"
+
+using std::vector;
+
+/*
+	lower bound on the reduced cost that can still be added to a label, after it reaches a request at a given time
+
+	built by a backward pass over time buckets, before labeling:
+		bound(j, b) = min(0, min over k of [ lateness(k, earliest arrival) - beta_k - edge dual(j, k) + bound(k, arrival bucket) ])
+
+	the earliest arrival at k, leaving j at any time of bucket b, is max(bucket start + service and trip of j, arrival time of k),
+	as every expansion of RouteExpander takes at least the service and trip time of the last request. Lateness only grows with time,
+	so this never overestimates the reduced cost of a route, regardless of the waiting station policy (routes need not be elementary)
+
+	a label at request j that has reducedCost + Get(j, time) > -RCEpsilon can never lead to a route with negative reduced cost
+
+	Get() is a step function: the value of a bucket is computed for a departure at the bucket start, which bounds every departure inside
+	the bucket (the minimum over the bucket), and buckets never decrease in time. Values are never interpolated between buckets.
+	Times before the first bucket are clamped to it, which is safe as it starts no later than any label, see Build
+
+	pruning is valid for every pricing tier and with ng-routes: the bound only relaxes the labeling (it allows every cycle except j -> j,
+	which the labeling never expands either), and a pruned label is dominated by no label that is kept, as the bound is non-decreasing
+*/
+class CompletionBound
+{
+	int nbConsidered;
+	int nbBuckets;
+	double startTime;
+	double bucketWidth;
+	bool valid; //false if the bound could not be built. Get() returns -HUGE_VAL, so nothing is pruned
+
+	vector<double> bound; //nbBuckets x nbConsidered. Non-decreasing in time: later labels can recover less
+
+	int Bucket(double time) const
+	{
+		int b = (int) std::floor((time - startTime) / bucketWidth);
+		return std::clamp(b, 0, nbBuckets - 1);
+	}
+
+public:
+	CompletionBound() : nbConsidered(0), nbBuckets(0), startTime(0.0), bucketWidth(1.0), valid(false) {}
+
+	//consideredRequests are request ids. Get() is indexed by position in consideredRequests
+	void Build(ProblemData* problemData, int vehicle_id, const vector<int>& consideredRequests, const vector<double>& beta_duals, const PricingEdges& edges, int maxBuckets);
+
+	void Clear() { valid = false; }
+
+	double Get(int iConsidered, double time) const
+	{
+		if(!valid) return -HUGE_VAL;
+		assert(time >= startTime - 1e-6);
+		return bound[(size_t) Bucket(time) * nbConsidered + iConsidered];
+	}
+};
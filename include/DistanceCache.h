@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+#include "DistanceMatrix.h"
+
+using std::string;
+
+/*
+	float64 distance matrices stored on disk, one file per key, shared by every run pointing to the same directory.
+	The inputs are the bytes of whatever the matrix was built from (see ProblemData::CalculateDistances), and the key is their hash, so any change
+	in coordinates, counts or distance type gives a new file. Files also hold the inputs, which must match on a hit, so that hash collisions miss
+
+	files are memory mapped read-only: a hit costs an open and an mmap, and the pages are shared between processes on the same node.
+	Several processes may ask for the same key at once. A file lock makes one of them build the matrix while the others wait, and files
+	are written under a temporary name and renamed, so a reader never sees a partial file. The lock file is removed once the matrix is stored.
+	Cache errors are reported and the matrix built anyway
+*/
+class DistanceCache
+{
+	string directory;
+
+	string PathOf(uint64_t key, const char* extension) const;
+
+	//mapped matrix for key if there is a valid file for it, built from the same inputs
+	bool Load(uint64_t key, const string &inputs, int nbVehicles, int nbRequests, int nbWaitingStations, DistanceMatrix &outMatrix) const;
+	void Store(uint64_t key, const string &inputs, const DistanceMatrix &matrix) const;
+
+public:
+	explicit DistanceCache(string directory) : directory(directory) {}
+
+	//FNV-1a, chained through seed
+	static uint64_t Hash(const void* data, size_t bytes, uint64_t seed = 14695981039346656037ULL);
+
+	//matrix stored for inputs, or build()'s result, which is then stored. build() must give a float64 matrix with the given counts
+	DistanceMatrix GetOrBuild(const string &inputs, int nbVehicles, int nbRequests, int nbWaitingStations, const std::function<DistanceMatrix()> &build) const;
+};
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+#include <limits>
+#include <stdexcept>
+#include <assert.h>
+
+#include "PricingThreadPool.h"
+
+using std::vector;
+
+/*
+	how DistanceMatrix stores each distance (travel time, in seconds):
+		- float64: exact
+		- float32: relative error below 2^-24, that is below 0.01s for any distance under a day.
+		  Route durations add up a few of these, so reduced costs may move by about (number of stops) * 0.01s
+*/
+enum class DistancePrecision {float64, float32};
+
+// distances from a vertex to a contiguous block of vertices, stored as T. See DistanceMatrix
+template <class T>
+class DistanceRow
+{
+	const T* values;
+
+public:
+	explicit DistanceRow(const T* values) : values(values) {}
+
+	double operator[](size_t j) const { return values[j]; }
+};
+
+/*
+	vertex-to-vertex distances, keeping only the blocks the routing reads. Vertex ids are ordered by type (see ProblemData):
+	initial positions [0, V), requests [V, V + R), their destinations [V + R, V + 2R) and waiting stations [V + 2R, V + 2R + W)
+
+	stored blocks, in a single buffer:
+		- initial positions, destinations and waiting stations to the "targets": requests, then waiting stations. One row of R + W per vertex
+		- requests to waiting stations, and each request to its own destination (request id + R)
+		- waiting stations to the targets again, transposed, so that loops over the waiting stations towards a single vertex read contiguous memory
+	request to request, to other destinations or to initial positions, destination to destination, and anything to initial positions are never
+	used by the routing, and aren't stored (see IsStored). For large request counts, this is about a fourth of the dense matrix
+
+	rows are typed by the storage precision: loops over a row should check Precision() once and read a DistanceRow<float> or DistanceRow<double>
+
+	the buffer is immutable once built and shared between copies, so copying a ProblemData doesn't copy it
+*/
+class DistanceMatrix
+{
+	int nbVehicles;
+	int nbRequests;
+	int nbWaitingStations;
+	int nbTargets; //nbRequests + nbWaitingStations
+
+	DistancePrecision precision;
+	double maxError; //largest difference to the distances the matrix was built from
+
+	std::shared_ptr<const void> buffer; //of the precision's type
+	const void* values;
+	size_t size;
+
+	//offsets of the blocks in the buffer. targetRows is at 0
+	size_t requestsToStations;
+	size_t requestsToDestinations;
+	size_t fromStations;
+
+	int FirstRequest() const { return nbVehicles; }
+	int FirstDestination() const { return nbVehicles + nbRequests; }
+	int FirstWaitingStation() const { return nbVehicles + 2 * nbRequests; }
+	bool IsRequest(int id) const { return id >= FirstRequest() && id < FirstDestination(); }
+	bool IsWaitingStation(int id) const { return id >= FirstWaitingStation() && id < NbVertices(); }
+	bool IsTarget(int id) const { return IsRequest(id) || IsWaitingStation(id); }
+
+	//destinations and waiting stations come right after the initial positions in the target rows
+	size_t TargetRow(int id) const { return id < FirstRequest() ? id : id - nbRequests; }
+	size_t TargetColumn(int id) const { return IsRequest(id) ? id - FirstRequest() : id - FirstWaitingStation() + nbRequests; }
+
+	template <class T>
+	static DistancePrecision PrecisionOf()
+	{
+		static_assert(std::is_same<T, double>::value || std::is_same<T, float>::value, "distances are stored as double or float");
+		return std::is_same<T, float>::value ? DistancePrecision::float32 : DistancePrecision::float64;
+	}
+
+	template <class T>
+	const T* Values(size_t offset) const
+	{
+		assert(PrecisionOf<T>() == precision);
+		return static_cast<const T*>(values) + offset;
+	}
+
+	template <class T>
+	double Get(int i, int j) const
+	{
+		if(IsRequest(i))
+		{
+			if(j == i + nbRequests) return Values<T>(requestsToDestinations)[i - FirstRequest()];
+			if(IsWaitingStation(j)) return Values<T>(requestsToStations)[(size_t) (i - FirstRequest()) * nbWaitingStations + j - FirstWaitingStation()];
+		}
+		else if(IsTarget(j))
+		{
+			return Values<T>(TargetRow(i) * nbTargets)[TargetColumn(j)];
+		}
+		return i == j ? 0.0 : std::numeric_limits<double>::quiet_NaN();
+	}
+
+	DistanceMatrix(int nbVehicles, int nbRequests, int nbWaitingStations)
+		: nbVehicles(nbVehicles), nbRequests(nbRequests), nbWaitingStations(nbWaitingStations), nbTargets(nbRequests + nbWaitingStations),
+		precision(DistancePrecision::float64), maxError(0.0), values(NULL)
+	{
+		requestsToStations = (size_t) (nbVehicles + nbRequests + nbWaitingStations) * nbTargets;
+		requestsToDestinations = requestsToStations + (size_t) nbRequests * nbWaitingStations;
+		fromStations = requestsToDestinations + nbRequests;
+		size = fromStations + (size_t) nbTargets * nbWaitingStations;
+	}
+
+	template <class T>
+	void SetBuffer(std::shared_ptr<const vector<T>> typedBuffer)
+	{
+		assert(typedBuffer->size() == size);
+		precision = PrecisionOf<T>();
+		buffer = typedBuffer;
+		values = typedBuffer->data();
+	}
+
+	template <class T, class F>
+	static DistanceMatrix BuildAs(int nbVehicles, int nbRequests, int nbWaitingStations, F &rowDistances, PricingThreadPool* pool)
+	{
+		DistanceMatrix out(nbVehicles, nbRequests, nbWaitingStations);
+		vector<T> v(out.size);
+
+		//rows are calculated as doubles in a scratch row per worker, then stored as T, so the matrix is never held in double as well
+		int nbWorkers = pool != NULL ? pool->NbThreads() : 1;
+		vector<vector<double>> scratch(nbWorkers, vector<double>(std::max(out.nbTargets, 1)));
+		vector<double> workerErrors(nbWorkers, 0.0);
+		auto store = [&](int worker, int i, int first, int last, T* row)
+		{
+			double* distances = scratch[worker].data();
+			rowDistances(i, first, last, distances);
+			for(int k = 0; k < last - first; k++)
+			{
+				row[k] = (T) distances[k];
+				workerErrors[worker] = std::max(workerErrors[worker], std::abs((double) row[k] - distances[k]));
+			}
+		};
+
+		//every vertex's stored rows
+		int nbVertices = out.NbVertices();
+		auto vertexRows = [&](int worker, int i)
+		{
+			if(out.IsRequest(i))
+			{
+				store(worker, i, out.FirstWaitingStation(), nbVertices, v.data() + out.requestsToStations + (size_t) (i - out.FirstRequest()) * nbWaitingStations);
+				store(worker, i, i + nbRequests, i + nbRequests + 1, v.data() + out.requestsToDestinations + (i - out.FirstRequest()));
+			}
+			else
+			{
+				T* row = v.data() + out.TargetRow(i) * out.nbTargets;
+				store(worker, i, out.FirstRequest(), out.FirstDestination(), row);
+				store(worker, i, out.FirstWaitingStation(), nbVertices, row + nbRequests);
+			}
+		};
+		if(pool != NULL) pool->Run(nbVertices, vertexRows);
+		else for(int i = 0; i < nbVertices; i++) vertexRows(0, i);
+
+		for(int t = 0; t < out.nbTargets; t++)
+		{
+			for(int w = 0; w < nbWaitingStations; w++)
+			{
+				v[out.fromStations + (size_t) t * nbWaitingStations + w] = v[out.TargetRow(out.FirstWaitingStation() + w) * out.nbTargets + t];
+			}
+		}
+
+		out.SetBuffer(std::make_shared<const vector<T>>(std::move(v)));
+		out.maxError = *std::max_element(workerErrors.begin(), workerErrors.end());
+		return out;
+	}
+
+	//copy of the buffer converted to T
+	template <class T, class S>
+	void Convert(const DistanceMatrix &source)
+	{
+		vector<T> converted(size);
+		const S* sourceValues = source.Values<S>(0);
+		maxError = 0.0;
+		for(size_t k = 0; k < size; k++)
+		{
+			converted[k] = (T) sourceValues[k];
+			maxError = std::max(maxError, std::abs((double) converted[k] - (double) sourceValues[k]));
+		}
+		SetBuffer(std::make_shared<const vector<T>>(std::move(converted)));
+	}
+
+public:
+	DistanceMatrix() : DistanceMatrix(0, 0, 0) {}
+
+	/*
+		rowDistances(i, first, last, out) writes the distances from vertex i to vertices [first, last) to out[0, last - first).
+		It is only called for the stored pairs, including i to i for waiting stations. With a pool, it is called from the pool's threads.
+		Distances are stored with the given precision as soon as each row is calculated
+	*/
+	template <class F>
+	static DistanceMatrix Build(int nbVehicles, int nbRequests, int nbWaitingStations, F rowDistances, PricingThreadPool* pool = NULL,
+		DistancePrecision precision = DistancePrecision::float64)
+	{
+		if(precision == DistancePrecision::float32) return BuildAs<float>(nbVehicles, nbRequests, nbWaitingStations, rowDistances, pool);
+		return BuildAs<double>(nbVehicles, nbRequests, nbWaitingStations, rowDistances, pool);
+	}
+
+	/*
+		matrix over an existing float64 buffer of bytes bytes, laid out as Data() of a matrix with the same counts (e.g. memory mapped, see DistanceCache).
+		The buffer is kept alive by the shared_ptr. Throws std::invalid_argument if its size doesn't match
+	*/
+	static DistanceMatrix FromBuffer(int nbVehicles, int nbRequests, int nbWaitingStations, std::shared_ptr<const void> buffer, size_t bytes)
+	{
+		DistanceMatrix out(nbVehicles, nbRequests, nbWaitingStations);
+		if(bytes != out.size * sizeof(double)) throw std::invalid_argument("distance buffer doesn't match the vertex counts");
+		out.buffer = buffer;
+		out.values = buffer.get();
+		return out;
+	}
+
+	//copy of this matrix stored with the given precision
+	DistanceMatrix WithPrecision(DistancePrecision newPrecision) const
+	{
+		DistanceMatrix out = *this;
+		if(newPrecision == precision) return out;
+
+		if(newPrecision == DistancePrecision::float32) out.Convert<float, double>(*this);
+		else out.Convert<double, float>(*this);
+		//error adds up if this matrix was already reduced
+		out.maxError += maxError;
+		return out;
+	}
+
+	int NbVertices() const { return nbVehicles + 2 * nbRequests + nbWaitingStations; }
+	int NbVehicles() const { return nbVehicles; }
+	int NbRequests() const { return nbRequests; }
+	int NbWaitingStations() const { return nbWaitingStations; }
+	DistancePrecision Precision() const { return precision; }
+	double MaxError() const { return maxError; }
+	size_t MemoryUsage() const { return size * (precision == DistancePrecision::float32 ? sizeof(float) : sizeof(double)); } //in bytes
+	const void* Data() const { return values; } //MemoryUsage() bytes of the precision's type
+
+	//is the distance from i to j in one of the stored blocks? Any vertex to itself counts, as 0
+	bool IsStored(int i, int j) const
+	{
+		if(i == j) return true;
+		if(IsRequest(i)) return j == i + nbRequests || IsWaitingStation(j);
+		return IsTarget(j);
+	}
+
+	//only for stored pairs (see IsStored). Other pairs give NaN
+	double operator()(int i, int j) const
+	{
+		assert(i >= 0 && j >= 0 && i < NbVertices() && j < NbVertices());
+		assert(IsStored(i, j));
+		return precision == DistancePrecision::float32 ? Get<float>(i, j) : Get<double>(i, j);
+	}
+
+	//distances from i, which isn't a request, to every request, by request index. T must match Precision()
+	template <class T>
+	DistanceRow<T> ToRequests(int i) const
+	{
+		assert(i >= 0 && i < NbVertices() && !IsRequest(i));
+		return DistanceRow<T>(Values<T>(TargetRow(i) * nbTargets));
+	}
+
+	//distances from i to every waiting station, by waiting station index. T must match Precision()
+	template <class T>
+	DistanceRow<T> ToWaitingStations(int i) const
+	{
+		assert(i >= 0 && i < NbVertices());
+		if(IsRequest(i)) return DistanceRow<T>(Values<T>(requestsToStations + (size_t) (i - FirstRequest()) * nbWaitingStations));
+		return DistanceRow<T>(Values<T>(TargetRow(i) * nbTargets + nbRequests));
+	}
+
+	//distances from every waiting station to j, a request or a waiting station, by waiting station index. T must match Precision()
+	template <class T>
+	DistanceRow<T> FromWaitingStations(int j) const
+	{
+		assert(IsTarget(j));
+		return DistanceRow<T>(Values<T>(fromStations + TargetColumn(j) * nbWaitingStations));
+	}
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <vector>
+
+#include "ProblemData.h"
+
+using std::vector;
+
+/*
+	geodesic travel times between many positions, the same as ProblemData::geodesicDistance but a row at a time:
+	each position's unit vector on the sphere is computed once, and a row is the chord lengths from one position followed by asin.
+	Two distances at a time with SSE2, and the same arithmetic in scalar code elsewhere
+
+	asin is a polynomial instead of std::asin so that it vectorizes. Travel times t match geodesicDistance's t' with |t - t'| <= 1e-12 t' + 1e-9s.
+	The absolute part is for close positions, where the chord of either path is only accurate to a few ulps of the earth's radius
+*/
+class GeodesicKernel
+{
+	vector<double> x, y, z; //unit vectors, by position index
+	double scale; //earth's diameter over the speed, in seconds. Travel time is scale * asin(chord / 2)
+
+public:
+	// speed in m/s
+	GeodesicKernel(const vector<Position> &positions, double speed);
+
+	//out[k] is the travel time from position i to position first + k, for k in [0, last - first)
+	void Row(int i, int first, int last, double* out) const;
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+#include <set>
+#include <map>
+
+#include "ProblemData.h"
+#include "ProblemSolution.h"
+#include "BasePricing.h"
+#include "PricingArena.h"
+
+using std::vector;
+
+/*
+	label-setting pricing: labels are expanded once, in increasing time order, from a priority queue
+
+	since label times only grow along a route (non-antecipativity), when a label is popped every label
+	with smaller time has already been popped. So, the labels kept for each request arrive in time order,
+	and checking if a label is dominated (some earlier label with better reduced cost) only needs the best reduced cost seen so far.
+	There are no repeated sweeps over the requests as in SpacedBellmanPricing
+
+	uses the same dominance rule (RCEpsilon) and best labels heap as the exact mode of SpacedBellmanPricing, which also keeps
+	and expands dominated labels that entered the heap. Unlike it, a queued label is checked again when popped, against the labels
+	expanded since, while SpacedBellmanPricing only compares a new label with the one just before it in time. So the two expand
+	different labels and may return different routes. There is no heuristic mode
+*/
+class LabelSettingPricing final : public BasePricing
+{
+	struct PricingLabel
+	{
+		int reqIndex; //index in consideredRequests
+		double reducedCost;
+		double time;
+		int lastWaitingStation; //-1 if no waiting station was visited between lastLabel and this
+		IntermediateVertex* intermediatePosition;
+		const PricingLabel* lastLabel;
+		bool best; //entered the best labels heap, so it is expanded even if dominated
+	};
+
+	//priority queue order: earliest label first, best reduced cost first on ties
+	struct CompLabelOrder
+	{
+		bool operator()(const PricingLabel* l1, const PricingLabel* l2) const
+		{
+			if(l1->time != l2->time) return l1->time > l2->time;
+			return l1->reducedCost > l2->reducedCost;
+		}
+	};
+
+	static bool compLRC(const PricingLabel &l1, const PricingLabel &l2) { return l1.reducedCost < l2.reducedCost; }
+
+	PricingReturn pricing_ret;
+
+	// owns every label and intermediate position of a Price call
+	PricingArena arena;
+
+	// best reduced cost of the labels already expanded at each considered request
+	vector<double> bestExpandedRC;
+	vector<size_t> nbExpanded;
+
+	vector<const PricingLabel*> queue; //heap ordered by CompLabelOrder
+
+	//heap storing best labels, ordered such that worst label in on the head. Copies, so they may be dominated labels that were never stored
+	size_t n_desired_routes;
+	vector<PricingLabel> bestLabelsHeap;
+	bool TryAddToBestLabelsHeap(const PricingLabel &label);
+
+	//returns true if label was queued for expansion
+	bool TryAddLabel(const PricingLabel &label);
+
+	void Cleanup();
+
+public:
+	LabelSettingPricing(Params *params, ProblemData* problemData);
+	~LabelSettingPricing(){}
+
+	PricingReturn Price(int vehicle_id, int n_routes, vector<double>& alpha_duals, vector<double>& beta_duals, vector<Route>& outRoutes, vector<int> consideredRequests, const PricingEdges& edges);
+};
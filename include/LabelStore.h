@@ -0,0 +1,166 @@
+#pragma once
+
+#include <vector>
+#include <set>
+#include <memory>
+#include <memory_resource>
+#include <algorithm>
+#include <iterator>
+#include <assert.h>
+
+#include "PricingArena.h"
+
+using std::vector;
+
+/*
+	containers for the labels of a single request, used by SpacedBellmanPricing
+
+	both keep labels ordered by *increasing time* and give stable handles (Label*) to stored labels,
+	so that lastLabel back-pointers stay valid while new labels are inserted.
+	Iterators are also stable under insertion *after* them, which is what ItrNextExpansion relies on.
+
+	Label is expected to have double members 'time' and 'reducedCost'
+
+	labels and container nodes are taken from a PricingArena, so nothing is freed when a store is cleared or destroyed:
+	the owner resets the arena once the stores are gone
+*/
+
+/*
+	original storage: one arena allocation plus one red-black tree node per label
+*/
+template <class Label>
+class MultisetLabelStore
+{
+	struct CompLTime
+	{
+		using is_transparent = void; //allows upper_bound by time without building a throwaway label
+
+		bool operator()(const Label* l1, const Label* l2) const { return l1->time < l2->time; }
+		bool operator()(double time, const Label* l) const { return time < l->time; }
+		bool operator()(const Label* l, double time) const { return l->time < time; }
+	};
+
+	PricingArena* arena;
+	std::pmr::multiset<Label*, CompLTime> labels;
+
+public:
+	using iterator = typename std::pmr::multiset<Label*, CompLTime>::iterator;
+
+	explicit MultisetLabelStore(PricingArena* arena) : arena(arena), labels(arena) {}
+
+	iterator begin() { return labels.begin(); }
+	iterator end() { return labels.end(); }
+	size_t size() const { return labels.size(); }
+
+	Label* Get(iterator itr) const { return *itr; }
+	double Time(iterator itr) const { return (*itr)->time; }
+	double ReducedCost(iterator itr) const { return (*itr)->reducedCost; }
+
+	//first position whose time is strictly greater than time
+	iterator UpperBound(double time) { return labels.upper_bound(time); }
+
+	// inserts a copy of label just before position, which must be UpperBound(label.time)
+	iterator Insert(iterator position, const Label& label)
+	{
+		return labels.insert(position, arena->New(label));
+	}
+
+	template <class Pred>
+	size_t EraseIf(Pred pred)
+	{
+		return std::erase_if(labels, [&pred](const Label* label){ return pred(*label); });
+	}
+
+	void clear() { labels.clear(); }
+};
+
+/*
+	bucket storage:
+		- label payloads are copied into the arena, so they never move once stored
+		- a sorted vector keeps (time, reducedCost, Label*) entries contiguous in memory,
+		  so searching for the insert position and checking dominance don't chase pointers
+
+	iterators are positions in the sorted vector. An insertion shifts the positions after it,
+	but never the ones before it, so iterators stay valid as long as insertions happen after them
+	(or the iterator is explicitly moved to the inserted label, as SpacedBellmanPricing does)
+*/
+template <class Label>
+class BucketLabelStore
+{
+	struct Entry
+	{
+		double time;
+		double reducedCost;
+		Label* label;
+	};
+
+	PricingArena* arena;
+	std::pmr::vector<Entry> order; // ordered by increasing time. Buffers left behind when it grows are only reclaimed by the arena reset
+
+	static bool compTimeEntry(double time, const Entry &entry) { return time < entry.time; }
+
+public:
+	class iterator
+	{
+		friend class BucketLabelStore;
+		size_t pos;
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using difference_type = std::ptrdiff_t;
+		using value_type = size_t;
+		using pointer = void;
+		using reference = size_t;
+
+		iterator() : pos(0) {}
+		explicit iterator(size_t pos) : pos(pos) {}
+
+		size_t operator*() const { return pos; }
+		iterator& operator++() { pos++; return *this; }
+		iterator operator++(int) { iterator ret = *this; pos++; return ret; }
+		iterator& operator--() { pos--; return *this; }
+		iterator operator--(int) { iterator ret = *this; pos--; return ret; }
+		bool operator==(const iterator &other) const { return pos == other.pos; }
+		bool operator!=(const iterator &other) const { return pos != other.pos; }
+	};
+
+	explicit BucketLabelStore(PricingArena* arena) : arena(arena), order(arena) {}
+
+	iterator begin() { return iterator(0); }
+	iterator end() { return iterator(order.size()); }
+	size_t size() const { return order.size(); }
+
+	Label* Get(iterator itr) const { return order[itr.pos].label; }
+	double Time(iterator itr) const { return order[itr.pos].time; }
+	double ReducedCost(iterator itr) const { return order[itr.pos].reducedCost; }
+
+	iterator UpperBound(double time)
+	{
+		//most new labels are later than every stored one, so test the back first
+		if(order.empty() || order.back().time <= time) return end();
+		auto itr = std::upper_bound(order.begin(), order.end(), time, compTimeEntry);
+		return iterator(itr - order.begin());
+	}
+
+	iterator Insert(iterator position, const Label& label)
+	{
+		assert(position.pos <= order.size());
+		Entry entry;
+		entry.time = label.time;
+		entry.reducedCost = label.reducedCost;
+		entry.label = arena->New(label);
+		order.insert(order.begin() + position.pos, entry);
+		return position;
+	}
+
+	/*
+		only removes the entries from the time ordering. Payloads stay in the arena,
+		since other labels may still point to them through lastLabel
+	*/
+	template <class Pred>
+	size_t EraseIf(Pred pred)
+	{
+		return std::erase_if(order, [&pred](const Entry &entry){ return pred(*entry.label); });
+	}
+
+	void clear() { order.clear(); }
+};
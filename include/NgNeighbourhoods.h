@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <bit>
+
+#include "ProblemData.h"
+
+using std::vector;
+
+/*
+	ng-route neighbourhoods, for the ng-route relaxation of elementarity in the pricing. Indexed by request *index*
+
+	N(i) holds i itself (position 0) and the size - 1 requests closest to the destination of i, which are the most likely to follow it.
+	A label at request i keeps a memory M, a bitset over the positions of N(i). Going from i to j is forbidden if j is in M,
+	and the memory of the new label is (M intersected with N(j)) plus j.
+	So a route never returns to a request while it's remembered, which forbids most short cycles without full elementarity
+
+	a label only dominates another one of the same request if its memory is a subset of the other's
+*/
+class NgNeighbourhoods
+{
+public:
+	static constexpr int MaxSize = 64; //memories are a single word
+
+private:
+	int nbRequests;
+	int size; //neighbourhood size, including the request itself
+
+	vector<int> neighbours; // nbRequests rows of size request indices
+	vector<int8_t> position; // nbRequests x nbRequests: position of the column request in the neighbourhood of the row request, -1 if not in it
+
+	NgNeighbourhoods() = default;
+
+public:
+	static std::shared_ptr<const NgNeighbourhoods> Build(ProblemData *problemData, int size);
+
+	//was this built for the requests of problemData?
+	bool Matches(const ProblemData *problemData) const { return problemData->NbRequests() == nbRequests; }
+
+	int Size() const { return size; }
+
+	//memory of a route that only visited request index i
+	static uint64_t Initial() { return 1; }
+
+	//is going from request index iLast (with memory) to request index iNext forbidden?
+	bool Forbids(uint64_t memory, int iLast, int iNext) const
+	{
+		int p = position[(size_t) iLast * nbRequests + iNext];
+		return p >= 0 && ((memory >> p) & 1);
+	}
+
+	//memory after going from request index iLast (with memory) to request index iNext
+	uint64_t Extend(uint64_t memory, int iLast, int iNext) const
+	{
+		uint64_t newMemory = Initial();
+		const int* lastNeighbours = &neighbours[(size_t) iLast * size];
+		const int8_t* nextPosition = &position[(size_t) iNext * nbRequests];
+		for(; memory != 0; memory &= memory - 1)
+		{
+			int q = nextPosition[lastNeighbours[std::countr_zero(memory)]];
+			if(q >= 0) newMemory |= uint64_t(1) << q;
+		}
+		return newMemory;
+	}
+
+	//can a label with memory1 dominate one with memory2, at the same request?
+	static bool IsSubset(uint64_t memory1, uint64_t memory2) { return (memory1 & ~memory2) == 0; }
+};
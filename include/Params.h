@@ -8,7 +8,10 @@ using std::string;
 
 
 
-enum class PricingAlgorithm {DAG, bellman, spacedBellman, spacedBellman2, bellmanWSets, spacedBellmanWSets, PricerTester, hybrid};
+enum class PricingAlgorithm {DAG, bellman, spacedBellman, spacedBellman2, bellmanWSets, spacedBellmanWSets, PricerTester, hybrid, labelSetting, bidirectional};
+
+//container used for the labels of each request in the spacedBellman pricing. See LabelStore.h
+enum class LabelStorage {multiset, bucket};
 
 /*
 
@@ -44,11 +47,46 @@ public:
 */
 	
 	int newRoutesPerPricing;
+	int pricingThreads; //number of vehicles priced at once. 1 -> sequential pricing
+	bool useVehicleClasses; //price equivalent vehicles once, see ProblemData::GetVehicleClass
+	bool useTransitionTable; //precompute request-to-request transitions for the pricing, see TransitionTable
+	bool useCompletionBounds; //prune labels that cannot reach a negative reduced cost, see CompletionBound
+	int completionBoundBuckets; //time buckets of the completion bounds
+	int ngNeighbourhoodSize; //ng-route relaxation in the spacedBellman pricing, see NgNeighbourhoods. 0 -> routes may have any cycle
+	double bidirectionalMidpoint; //fraction of the vehicle's remaining horizon where the bidirectional pricing joins, see BidirectionalPricing
+
+	/*
+		heuristic pricing tiers, tried in order until one finds columns: the greedy heuristic, 
+		then one tier per entry of heuristicLabelLimits, keeping at most that many labels per request. Exact pricing runs when every tier fails
+	*/
+	static constexpr int MaxHeuristicLabelLimits = 6;
+	vector<int> heuristicLabelLimits;
+
+	//re-cost the labels of the previous pricing of a vehicle with the new duals before labeling, see SpacedBellmanPricing::LabelTree
+	bool useIncrementalPricing;
+	double incrementalMaxChangedDuals; //fraction of the request duals. If more have changed, labeling runs from scratch
+
+	int columnPoolSize; //routes kept in the pricer's column pool, see ColumnPool. 0 -> no pool
+	int columnPoolMaxAge; //pricing rounds a pool route is kept without having negative reduced cost
+
+	//Wentges smoothing of the pricing duals, in [0, 1): dualSmoothing * stability center + (1 - dualSmoothing) * LP duals. 0 -> LP duals
+	double dualSmoothing;
+
+	//pricing stops once it has newRoutesPerPricing columns with reduced cost below -earlyExitFraction * |LP objective|. 0 -> never
+	double earlyExitFraction;
+
+	/*
+		Lagrangian bound of the node (LP objective + most negative reduced cost of each vehicle), passed to SCIP to prune nodes before column generation ends.
+		Rounds of exact pricing then price every vehicle instead of stopping at the first one with columns
+	*/
+	bool useLagrangianBound;
+	double cgGapTolerance; //column generation at a node stops once LP objective - Lagrangian bound <= cgGapTolerance * |LP objective|. 0 -> never
 
 	double initialDSF;
 	double DSFDecrement;
 
 	PricingAlgorithm pricingAlgorithm;
+	LabelStorage labelStorage;
 
 
 	double max_time; //max optimization time in seconds
@@ -91,6 +129,7 @@ public:
 	Params()
 	{
 		pricingAlgorithm = PricingAlgorithm::DAG;
+		labelStorage = LabelStorage::multiset;
 
 
 		max_time = 3600;
@@ -102,6 +141,22 @@ public:
 		useBranchingOnEdges = false;
 
 		newRoutesPerPricing = 1;
+		pricingThreads = 1;
+		useVehicleClasses = false;
+		useTransitionTable = false;
+		useCompletionBounds = false;
+		completionBoundBuckets = 100;
+		ngNeighbourhoodSize = 0;
+		bidirectionalMidpoint = 0.5;
+		heuristicLabelLimits = {};
+		earlyExitFraction = 0.0;
+		useIncrementalPricing = false;
+		incrementalMaxChangedDuals = 0.25;
+		columnPoolSize = 0;
+		columnPoolMaxAge = 50;
+		dualSmoothing = 0.0;
+		useLagrangianBound = false;
+		cgGapTolerance = 0.0;
 		initialDSF = 0.9;
 		DSFDecrement = 0.1;
 		alwaysLoopVehicles = false;
@@ -121,6 +176,7 @@ public:
 	Params(string pathToInstance, string instanceType = "pdptw")
 	{
 		pricingAlgorithm = PricingAlgorithm::DAG;
+		labelStorage = LabelStorage::multiset;
 
 		max_time = 3600;
 		max_memory = 1000;
@@ -131,6 +187,22 @@ public:
 		useBranchingOnEdges = false;
 
 		newRoutesPerPricing = 1;
+		pricingThreads = 1;
+		useVehicleClasses = false;
+		useTransitionTable = false;
+		useCompletionBounds = false;
+		completionBoundBuckets = 100;
+		ngNeighbourhoodSize = 0;
+		bidirectionalMidpoint = 0.5;
+		heuristicLabelLimits = {};
+		earlyExitFraction = 0.0;
+		useIncrementalPricing = false;
+		incrementalMaxChangedDuals = 0.25;
+		columnPoolSize = 0;
+		columnPoolMaxAge = 50;
+		dualSmoothing = 0.0;
+		useLagrangianBound = false;
+		cgGapTolerance = 0.0;
 		initialDSF = 0.9;
 		DSFDecrement = 0.1;
 		alwaysLoopVehicles = false;
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <new>
+#include <algorithm>
+#include <assert.h>
+
+using std::vector;
+using std::unique_ptr;
+
+/*
+	bump allocator for the short lived objects created during a single pricing call (labels, intermediate vertices, container nodes)
+
+	nothing is freed individually: Reset() makes all memory available again at once,
+	but keeps the chunks allocated so the next pricing call does not go back to malloc.
+
+	It is also a memory_resource, so std::pmr containers can take their nodes from it
+*/
+class PricingArena final : public std::pmr::memory_resource
+{
+	static constexpr size_t defaultChunkSize = 1 << 20; // 1MB
+
+	vector<unique_ptr<std::byte[]>> chunks;
+	vector<size_t> chunkSizes;
+
+	size_t currentChunk; // index of the chunk being used
+	size_t offset; // first free byte in the current chunk
+	size_t bytesUsed; // bytes handed out since last Reset(), including padding and bytes skipped at the end of chunks
+
+	void* do_allocate(size_t bytes, size_t alignment) override
+	{
+		while(currentChunk < chunks.size())
+		{
+			uintptr_t base = reinterpret_cast<uintptr_t>(chunks[currentChunk].get());
+			size_t aligned = ((base + offset + alignment - 1) & ~(alignment - 1)) - base;
+			if(aligned + bytes <= chunkSizes[currentChunk])
+			{
+				bytesUsed += aligned + bytes - offset;
+				offset = aligned + bytes;
+				return chunks[currentChunk].get() + aligned;
+			}
+
+			//doesn't fit, move on to the next chunk
+			bytesUsed += chunkSizes[currentChunk] - offset;
+			currentChunk++;
+			offset = 0;
+		}
+
+		//out of chunks, allocate a new one big enough for this request
+		size_t size = std::max(defaultChunkSize, bytes + alignment);
+		chunks.push_back(unique_ptr<std::byte[]>(new std::byte[size]));
+		chunkSizes.push_back(size);
+
+		return do_allocate(bytes, alignment);
+	}
+
+	// memory is only reclaimed by Reset()
+	void do_deallocate(void* /*p*/, size_t /*bytes*/, size_t /*alignment*/) override {}
+
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+public:
+	PricingArena() : currentChunk(0), offset(0), bytesUsed(0) {}
+
+	PricingArena(const PricingArena&) = delete;
+	PricingArena& operator=(const PricingArena&) = delete;
+
+	// copies obj into the arena. Destructors are never called, so only trivially destructible types are allowed
+	template <class T>
+	T* New(const T& obj)
+	{
+		static_assert(std::is_trivially_destructible_v<T>, "PricingArena never calls destructors");
+		void* ptr = allocate(sizeof(T), alignof(T));
+		return new (ptr) T(obj);
+	}
+
+	// invalidates everything allocated so far. Objects (and pmr containers) using the arena must be gone by now
+	void Reset()
+	{
+		currentChunk = 0;
+		offset = 0;
+		bytesUsed = 0;
+	}
+
+	size_t BytesUsed() const { return bytesUsed; }
+
+	size_t BytesReserved() const
+	{
+		size_t total = 0;
+		for(size_t size : chunkSizes) total += size;
+		return total;
+	}
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+using std::vector;
+
+/*
+	fixed pool of threads used to price several vehicles at once
+
+	threads are created once and sleep between calls to Run().
+	Each thread has a fixed worker index, so callers can keep per-worker state (e.g. one pricing algorithm per worker)
+*/
+class PricingThreadPool
+{
+	vector<std::thread> workers;
+
+	std::mutex mutex;
+	std::condition_variable workAvailable;
+	std::condition_variable workDone;
+
+	// current batch of work, protected by mutex
+	const std::function<void(int, int)>* task;
+	int nbTasks;
+	int nextTask;
+	int nbFinishedTasks;
+	size_t batchCounter; //incremented on every Run(), so sleeping workers know there is a new batch
+	std::exception_ptr error; //first exception thrown by a task in the current batch
+	bool stopping;
+
+	void WorkerLoop(int worker);
+
+public:
+	explicit PricingThreadPool(int nbThreads);
+	~PricingThreadPool();
+
+	PricingThreadPool(const PricingThreadPool&) = delete;
+	PricingThreadPool& operator=(const PricingThreadPool&) = delete;
+
+	int NbThreads() const { return workers.size(); }
+
+	// calls task(worker, i) for every i in [0, nbTasks) and blocks until all of them are finished
+	// if a task throws, the first exception is rethrown here once the batch is over
+	void Run(int nbTasks, const std::function<void(int worker, int task)> &task);
+};
@@ -10,6 +10,8 @@
 #include <climits>
 #include <map>
 
+#include "DistanceMatrix.h"
+
 using std::unique_ptr;
 using std::vector;
 using std::string;
@@ -28,6 +30,10 @@ enum class WaitingStationPolicy {
 	bestOptionalStop //ambulance may or may not stop. If stop, it may choose which ws to go to, picking the one with the best resulting time
 };
 
+class TransitionTable; //see RouteExpander.h
+class NgNeighbourhoods; //see NgNeighbourhoods.h
+class StaticInfrastructure; //see StaticInfrastructure.h
+
 struct Vehicle
 {
 	int type;
@@ -103,7 +109,6 @@ public:
 	int NbVehicles() const { return vehicles.size(); }
 	int NbWaitingStations() const { return waitingStations.size(); }
 
-	int GetClosestDestination(int vertexId) const;
 
 	string name;
 
@@ -117,6 +122,11 @@ public:
 	std::map<double, double> target_times_per_weight = {{1, 30*60}, {2, 15*60}, {4, 10*60}};
 
 	DistanceType distanceType;
+
+	//if not empty, calculated distance matrices are stored in and reused from this directory, see DistanceCache
+	static string distanceCacheDirectory;
+	//precision of the distance matrices of instances read or calculated from then on, see DistancePrecision. Cached and compiled files stay float64
+	static DistancePrecision distancePrecision;
 	
 private:
 
@@ -129,9 +139,15 @@ private:
 
 	// for computing this matrix, vertices are ordered by arbitrary id, in order
 	//vertices are ordered: initial_positions, requests, destination, waiting_stations, (projected_requests, projected_destination)
-	vector<vector<double>> distances; //distaces[i][j] -> distance from i to j
+	DistanceMatrix distances; //distances(i, j) -> distance from i to j
+
+	//bases, hospitals and cleaning bases shared with other instances read from the same files. Null if not read from Vincent's files
+	std::shared_ptr<const StaticInfrastructure> infrastructure;
 	
-	static void CalculateDistanceMatrix(vector<Vertex*> &vertices, vector<vector<double>> &outMatrix, DistanceType distanceType);
+	//calculates the distances the matrix stores between the current vertices, see DistanceMatrix. Geodesic ones in batches, see GeodesicKernel
+	//requestToDestination, by request index, replaces the calculated distance from each request to its destination
+	//infrastructureSites, by vertex id, is each vertex's site in infrastructure, or -1. Distances from sites to waiting stations are copied from it
+	void CalculateDistances(vector<Vertex*> &vertices, const vector<double>* requestToDestination = NULL, const vector<int>* infrastructureSites = NULL);
 
 public:	
 	//calculates distance between points considering instance characteristics
@@ -154,6 +170,15 @@ public:
 	//reads instance number instance_index from one of Vincent files, if possible
 	static bool readVincentInstance(string requests_path, string hospitals_path, string waiting_stations_path, string cleaning_stations_path, int instance_index, ProblemData &outInstance, bool tenColumns, std::string osmPath, bool useTimeHorizon = false, double timeHorizon = 0.0, int overwriteNbVehicles = -1); 
 
+	/*
+		compiled instances: the fully built instance (vertices, vehicles, distances, closest waiting stations and vehicle classes) in a binary file,
+		loaded by memory mapping it, without parsing or calculating anything. See InstanceConverter
+		the format is tied to this build's struct layouts: files from other versions or builds are rejected, and should be converted again
+	*/
+	void writeCompiledInstance(string path) const;
+	//throws std::invalid_argument if the file can't be read
+	static void readCompiledInstance(string path, ProblemData &outInstance);
+
 	//when using these getter functions, the usage (or not) of scenarios is transparent. 
 
 	const InitialPosition* GetInitialPosition(int id) const;
@@ -175,6 +200,14 @@ public:
 	// changes number of vehicles in the instance to the new number of vehicles, 
 	// by sequentially distributing vehicles amongts existing initial positions/waiting stations 
 	void ResetNumberOfVehicles(int newNbVehicles);
+
+	/*
+		vehicles with the same type, availability time, initial position and preferred waiting station 
+		have the same pricing problem, up to the constant vehicle dual. They're grouped in classes, computed when the instance is loaded
+	*/
+	int NbVehicleClasses() const { return vehicleClasses.size(); }
+	int GetVehicleClass(int vehicle_id) const { return vehicleClassOf[vehicle_id]; }
+	const vector<int>& GetVehicleClassMembers(int vehicleClass) const { return vehicleClasses[vehicleClass]; } //ordered by increasing vehicle id
 	
 private:
 	//these ones follow the same idea but arent useful outside of class
@@ -188,6 +221,27 @@ private:
 	void PrecomputeClosestWSs();
 	int GetClosestWaitingStation(int vertexId) const;
 
+	vector<vector<int>> vehicleClasses;
+	vector<int> vehicleClassOf;
+	void ComputeVehicleClasses();
+	bool AreVehiclesEquivalent(int veh1, int veh2) const;
+
+	//shared between copies, since it's immutable
+	std::shared_ptr<const TransitionTable> transitionTable;
+	std::shared_ptr<const NgNeighbourhoods> ngNeighbourhoods;
+
+public:
+	void SetTransitionTable(std::shared_ptr<const TransitionTable> table) { transitionTable = table; }
+
+	//NULL if there is no table, or if it was built for different settings (policy, rerouting...) than the current ones
+	const TransitionTable* GetTransitionTable() const;
+
+	void SetNgNeighbourhoods(std::shared_ptr<const NgNeighbourhoods> ng) { ngNeighbourhoods = ng; }
+
+	//NULL if the ng-route relaxation isn't used, or if the neighbourhoods were built for other requests
+	const NgNeighbourhoods* GetNgNeighbourhoods() const;
+private:
+
 public:
 
 	bool IsRequest(int id) const;
@@ -201,7 +255,17 @@ public:
 	// get distance for the ommited representation of a route
 	double OmmitedDistance(int i, int j);
 
-	double Distance(int i, int j);
+	/*
+		distance from vertex i to vertex j. The routing only reads the pairs the matrix stores (see DistanceMatrix::IsStored),
+		others, e.g. between two requests, are calculated from the positions
+	*/
+	double Distance(int i, int j) const
+	{
+		if(distances.IsStored(i, j)) return distances(i, j);
+		return calculateDistance(GetVertex(i)->position, GetVertex(j)->position, distanceType);
+	}
+
+	const DistanceMatrix& Distances() const { return distances; }
 
 	const Vehicle* getVehicle(int id) { return &vehicles[id]; }
 
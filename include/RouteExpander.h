@@ -1,13 +1,159 @@
 
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
 #include "Params.h"
 
 enum WhichStation { closest, best, preferred };
 
+/*
+    precomputed request-to-request transitions, built once per ProblemData for its waiting station policy
+
+    when leaving request i at time t (ready at its destination at t' = t + service + delivery), the arrival time at request j is
+        - t' + direct distance,                                     if t' >= arrival time of j
+        - min over waiting stations k of max(t' + toWS_k, arrival_j) + fromWS_k,   otherwise
+    which is piecewise linear in t', with slopes 0 or 1 and breakpoints at arrival_j - toWS_k.
+    Only waiting stations that aren't dominated (on both toWS + fromWS and fromWS) are kept, ordered by increasing toWS
+
+    policies that stop at the vehicle's preferred station depend on the vehicle, and aren't tabulated.
+    Rerouting isn't piecewise linear, so transitions that may reroute are left to RouteExpander::checkRouteExpansion
+
+    obs: checkRouteExpansion keeps the last waiting station within 0.1 of the best one found so far. 
+    The table picks the actual best one, so the arrival time may differ by less than 0.1
+*/
+class TransitionTable
+{
+public:
+    struct WSOption
+    {
+        double toWS; //from the destination of i to the waiting station
+        double fromWS; //from the waiting station to j
+        int ws_id;
+    };
+
+    struct Transition
+    {
+        double direct; //from the destination of i to j
+        double reroutingFrom; //if t' is greater than this, rerouting may happen and the transition is not tabulated
+        int firstOption;
+        int nbOptions;
+    };
+
+private:
+    int nbRequests;
+    WaitingStationPolicy policy;
+    bool allowRerouting;
+    double timeHorizon;
+
+    vector<double> readyOffset; // service time + distance to destination, per request index
+    vector<double> arrivalTimes; // per request index
+    vector<Transition> transitions; // [iLast * nbRequests + iNext]
+    vector<WSOption> options;
+
+    TransitionTable() = default;
+
+    //transitions and options, reading the distance rows as T (see DistanceMatrix::Precision)
+    template <class T>
+    void BuildTransitions(ProblemData *problemData);
+
+public:
+    //returns NULL if the waiting station policy of problemData can't be tabulated
+    static std::shared_ptr<const TransitionTable> Build(ProblemData *problemData);
+
+    //was this table built for problemData as it is configured now?
+    bool Matches(const ProblemData *problemData) const
+    {
+        return problemData->NbRequests() == nbRequests && problemData->waitingStationPolicy == policy 
+            && problemData->allowRerouting == allowRerouting && problemData->timeHorizon == timeHorizon;
+    }
+
+    size_t NbOptions() const { return options.size(); }
+
+    /*
+        evaluates going from request index iLast to request index iNext, as checkRouteExpansion would (vehicle compatibility is not checked here)
+        returns false if the transition is not tabulated for this time. Otherwise, outFeasible, outTime and outWaitingStationId are set
+    */
+    bool Evaluate(int iLast, int iNext, double lastArrivalTime, double timeAvailable, bool &outFeasible, double &outTime, int &outWaitingStationId) const
+    {
+        const Transition &tr = transitions[iLast * nbRequests + iNext];
+        double firstAvailable = std::max(lastArrivalTime, timeAvailable) + readyOffset[iLast];
+        double arrival = arrivalTimes[iNext];
+
+        if(firstAvailable >= arrival)
+        {
+            outTime = firstAvailable + tr.direct;
+            outWaitingStationId = -1;
+        }
+        else
+        {
+            if(firstAvailable > tr.reroutingFrom) return false;
+
+            //first option whose breakpoint was passed: from it on, the vehicle arrives at the ws after arrival_j
+            const WSOption* begin = &options[tr.firstOption];
+            const WSOption* end = begin + tr.nbOptions;
+            const WSOption* k = std::lower_bound(begin, end, arrival - firstAvailable, 
+                [](const WSOption &option, double wait){ return option.toWS < wait; });
+
+            outTime = HUGE_VAL;
+            outWaitingStationId = -1;
+            if(k != end)
+            {
+                outTime = firstAvailable + k->toWS + k->fromWS;
+                outWaitingStationId = k->ws_id;
+            }
+            if(k != begin && arrival + (k - 1)->fromWS <= outTime)
+            {
+                outTime = arrival + (k - 1)->fromWS;
+                outWaitingStationId = (k - 1)->ws_id;
+            }
+        }
+
+        outFeasible = outTime <= timeHorizon;
+        return true;
+    }
+
+    /*
+        appends the arrival times at iLast where the transition to iNext may change slope, jump or become infeasible.
+        Between two consecutive breakpoints, Evaluate is linear in lastArrivalTime (slope 0 or 1), or always infeasible
+    */
+    void Breakpoints(int iLast, int iNext, double timeAvailable, vector<double> &out) const
+    {
+        const Transition &tr = transitions[iLast * nbRequests + iNext];
+        double offset = readyOffset[iLast];
+        double arrival = arrivalTimes[iNext];
+
+        out.push_back(timeAvailable);
+        out.push_back(arrival - offset); //direct from here on
+        out.push_back(tr.reroutingFrom - offset);
+        out.push_back(timeHorizon - tr.direct - offset);
+
+        const WSOption* begin = &options[tr.firstOption];
+        const WSOption* end = begin + tr.nbOptions;
+        for(const WSOption* k = begin; k != end; k++)
+        {
+            out.push_back(arrival - k->toWS - offset); //arrives at the ws after arrival_j from here on
+            out.push_back(timeHorizon - k->toWS - k->fromWS - offset);
+            for(const WSOption* l = begin; l != end; l++)
+            {
+                out.push_back(arrival + l->fromWS - k->toWS - k->fromWS - offset); //k, not waiting, ties with l, waiting
+            }
+        }
+    }
+};
+
 class RouteExpander
 {
     Params *params;
 
 private:
+    //checkRouteExpansion, reading the distance rows as T (see DistanceMatrix::Precision)
+    template <class T>
+    bool checkRouteExpansionAs(ProblemData *problemData, int vehicle_id, const Request* nextRequest, const Vertex* lastVertex, double lastVertexArrivalTime, double& outTime, int& outWaitingStationId, bool &outUseIntermediateIntermediateVertex,  IntermediateVertex &outIntermediateVertex);
+
     
 
 public:
@@ -33,6 +179,26 @@ public:
 
     bool checkRouteExpansion(ProblemData *problemData, int vehicle_id, const Request* nextRequest, const Vertex* lastVertex, double lastVertexArrivalTime, double& outTime, int& outWaitingStationId, bool &outUseIntermediateIntermediateVertex,  IntermediateVertex &outIntermediateVertex);
 
+    /*
+        same as checkRouteExpansion, from a request to the next. 
+        Uses the transition table when possible (table may be NULL), iLast and iNext are the request indices
+    */
+    bool checkRequestExpansion(ProblemData *problemData, const TransitionTable* table, int vehicle_id, const Request* nextRequest, int iNext, const Request* lastRequest, int iLast, double lastVertexArrivalTime, double& outTime, int& outWaitingStationId, bool &outUseIntermediateIntermediateVertex,  IntermediateVertex &outIntermediateVertex)
+    {
+        if(table != NULL)
+        {
+            if (!problemData->IsCompatible(nextRequest, vehicle_id)) return false;
+
+            bool feasible = false;
+            if(table->Evaluate(iLast, iNext, lastVertexArrivalTime, problemData->getVehicle(vehicle_id)->timeAvailable, feasible, outTime, outWaitingStationId))
+            {
+                outUseIntermediateIntermediateVertex = false;
+                return feasible;
+            }
+        }
+        return checkRouteExpansion(problemData, vehicle_id, nextRequest, lastRequest, lastVertexArrivalTime, outTime, outWaitingStationId, outUseIntermediateIntermediateVertex, outIntermediateVertex);
+    }
+
     bool checkRouteExpansion(ProblemData *problemData, int vehicle_id, const Request* nextRequest, const Vertex* lastVertex, double lastVertexArrivalTime, double& outTime, int& outWaitingStationId)
     {
         IntermediateVertex intermediateVertex = IntermediateVertex();
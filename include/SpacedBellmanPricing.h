@@ -10,6 +10,10 @@
 #include "ProblemData.h"
 #include "ProblemSolution.h"
 #include "BasePricing.h"
+#include "LabelStore.h"
+#include "PricingArena.h"
+#include "CompletionBound.h"
+#include "NgNeighbourhoods.h"
 
 using std::vector;
 using std::shared_ptr;
@@ -18,7 +22,11 @@ using std::multiset;
 /*
 	implements a pricing algorithm in a bellman-ford like manner, 
 	but with several 'spaced' labels for each request, instead of just one
+
+	LabelStore is the container used for the labels of each request (see LabelStore.h). 
+	Both MultisetLabelStore and BucketLabelStore are instantiated, and are selected via Params::labelStorage
 */
+template <template <class> class LabelStore>
 class SpacedBellmanPricing final : public BasePricing
 {
 
@@ -30,6 +38,7 @@ class SpacedBellmanPricing final : public BasePricing
 		double time;
 		int lastWaitingStation; //-1 if no waiting station was visited between lastReqIndex and this
 		IntermediateVertex* intermediatePosition;
+		uint64_t ngMemory; //see NgNeighbourhoods. 0 if the ng-route relaxation isn't used
 		//double total_lateness;
 
 		const PricingLabel* lastLabel;
@@ -46,39 +55,85 @@ public:
 	bool useRepeatedSetVerification;
 
 	void SetHeuristicPricing(bool value){ heuristicPricing = value;}
+	void SetLabelLimit(int maxLabels){ limitNbLabels = maxLabels > 0; this->maxLabels = maxLabels; }
+	bool HasHeuristicModes() const { return true; }
 
 private:
 
 	PricingReturn pricing_ret;
 
 	static bool compGTime(const PricingLabel &l1, const PricingLabel &l2);
-	static bool compLRC(const unique_ptr<PricingLabel> &l1, const unique_ptr<PricingLabel> &l2);
-	static bool compLTime(const unique_ptr<PricingLabel> &l1, const unique_ptr<PricingLabel> &l2);
 	static bool compLRCRef(const PricingLabel &l1, const PricingLabel &l2);
 	static bool compLTimeRef(const PricingLabel &l1, const PricingLabel &l2);
 	static bool compGRC(const PricingLabel &l1, const PricingLabel &l2);
 
-	// each vector-per-request is ordered by *increasing time*
-	//vector<std::multiset < std::unique_ptr<PricingLabel>, decltype(compLTime)* >> labels;
-	vector< std::multiset < std::unique_ptr<PricingLabel> , decltype(compLTime)* > > labels; // has nbRequests labels
+	using LabelContainer = LabelStore<PricingLabel>;
+	using LabelIterator = typename LabelContainer::iterator;
+
+	// owns labels, intermediate vertices and label container nodes. Reset once per Price call and reused across calls.
+	// declared before labels, so it outlives them
+	PricingArena arena;
 
-	//vector<std::multiset <std::unique_ptr<PricingLabel>, decltype(compLTime)*::iterator> ItrNextExpansion;
+	// each container-per-request is ordered by *increasing time*
+	vector<LabelContainer> labels; // has nbRequests labels
 
 	bool heuristicPricing;
 	
 
-	vector<std::multiset <std::unique_ptr<PricingLabel>, decltype(compLTime)* >::iterator> ItrNextExpansion;
+	vector<LabelIterator> ItrNextExpansion;
 	vector<bool> ItrNextExpansion_IsValid; //is the iterator pointing to a valid location?
 
-	vector<IntermediateVertex*> intermediatePositions;
+	// built once per Price call if Params::useCompletionBounds, indexed like labels
+	CompletionBound completionBound;
+
+	// NULL if the ng-route relaxation isn't used. Set at the start of each Price call
+	const NgNeighbourhoods* ng;
+
+	/*
+		labels of the last full labeling of a vehicle class (equivalent vehicles have the same labels), kept for Params::useIncrementalPricing.
+		Times and lateness don't depend on the duals, so later calls only re-cost the subtrees under requests whose duals, incoming edges
+		or consideration changed. Every other label keeps its cost, shifted by the vehicle's alpha dual.
+		The best labels are returned without labeling if any has negative reduced cost
+	*/
+	struct LabelTreeNode
+	{
+		int reqId;
+		int reqIndex;
+		int parent; //-1 if leaving the initial position. Nodes are in preorder, so parents come before their children
+		int subtreeEnd; //the subtree of this node is [this node, subtreeEnd)
+		double time;
+		double lateness; //of reqId alone
+		double cost; //reduced cost without the alpha dual, with the duals of LabelTree
+		int lastWaitingStation;
+		int intermediate; //index in LabelTree::intermediates, -1 if none
+	};
+	struct LabelTree
+	{
+		vector<LabelTreeNode> nodes;
+		vector<IntermediateVertex> intermediates;
+		vector<vector<int>> nodesOfRequest; //by request index
+		vector<int> byCost; //nodes by increasing cost
+		vector<double> beta_duals; //when the tree was built
+		PricingEdges edges = PricingEdges(0); //when the tree was built
+	};
+	static constexpr size_t MaxLabelTreeSize = 50000; //larger trees aren't kept
+	vector<LabelTree> labelTrees; //per vehicle class, empty if none
+
+	void StoreLabelTree(int vehicle_id, double alpha_dual, const vector<double>& beta_duals, const PricingEdges& edges);
+
+	//fills bestLabelsHeap with the labels of the vehicle class's tree, re-costed. Returns false (and leaves no labels) if nothing could be reused
+	bool TryIncrementalPricing(int vehicle_id, double alpha_dual, const vector<double>& beta_duals, const vector<int>& consideredRequests, const PricingEdges& edges);
+
+	//builds the routes of bestLabelsHeap
+	void BuildRoutes(int vehicle_id, vector<Route>& outRoutes);
 
-	bool TryAddLabel(PricingLabel &newLabel, int j, bool initial);
+	bool TryAddLabel(PricingLabel &newLabel, int j, bool initial = false);
 
 	static bool comp(const PricingLabel& lhs, const PricingLabel& rhs);
 	static bool comp2(const PricingLabel* lhs, const PricingLabel* rhs);
 	bool comp3(const PricingLabel& lhs, const PricingLabel& rhs);
 
-	void FilterLabels(int index, PricingLabel &just_added, std::multiset <unique_ptr<PricingLabel>, decltype(compLTime)*>::iterator just_added_itr);
+	void FilterLabels(int index, PricingLabel &just_added, LabelIterator just_added_itr);
 
 	void Cleanup();
 
@@ -105,6 +160,6 @@ public:
 	// beta duals are the duals requestConstraints in MIP Solver (nbRequests total)
 	// n_routes indicates how many new routes we want: the algorithm may return less routes if there aren't enough feasible negative reduced cost routes
 	//returns true if routes with negative reduced cost were found
-	PricingReturn Price(int vehicle_id, int n_routes, vector<double>& alpha_duals, vector<double>& beta_duals, vector<Route>& outRoutes, vector<int> consideredRequests, std::set <pair<int, int>> forbiddenEdges, map<pair<int, int>, double> edgeDuals);
+	PricingReturn Price(int vehicle_id, int n_routes, vector<double>& alpha_duals, vector<double>& beta_duals, vector<Route>& outRoutes, vector<int> consideredRequests, const PricingEdges& edges);
 };
 
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+
+#include "ProblemData.h"
+
+using std::vector;
+using std::string;
+
+/*
+	bases, hospitals and cleaning bases of Vincent's instances, with the distances between them that the routing reads.
+	Every scenario of a call file shares these, so they are read and calculated once and the ProblemData of each scenario
+	only calculates the distances that depend on its calls (see ProblemData::readVincentInstance)
+
+	sites are numbered bases, then hospitals, then cleaning bases. Stored blocks:
+		- every site to every base: base -> base (waiting stations and initial positions), hospital and cleaning base -> base (destinations)
+		- hospital -> cleaning base, for the requests that need cleaning
+	immutable once built. Get() shares one object between every instance read from the same, unchanged, files
+*/
+class StaticInfrastructure
+{
+	vector<Position> bases;
+	vector<Position> hospitals;
+	vector<Position> cleaningBases;
+	DistanceType distanceType;
+
+	vector<double> toBases; //by site, then base
+	vector<double> hospitalsToCleaningBases; //by hospital, then cleaning base
+
+	void CalculateDistances();
+
+public:
+	//reads the three files, in the formats of Vincent's instances. Throws std::invalid_argument if they can't be read
+	static StaticInfrastructure Read(string basesPath, string hospitalsPath, string cleaningBasesPath, DistanceType distanceType);
+
+	//same as Read, but files already read by this process are shared instead of read again, unless their size or modification time changed since. Thread safe
+	static std::shared_ptr<const StaticInfrastructure> Get(string basesPath, string hospitalsPath, string cleaningBasesPath, DistanceType distanceType);
+
+	int NbBases() const { return bases.size(); }
+	int NbHospitals() const { return hospitals.size(); }
+	int NbCleaningBases() const { return cleaningBases.size(); }
+	int NbSites() const { return NbBases() + NbHospitals() + NbCleaningBases(); }
+	DistanceType Type() const { return distanceType; }
+
+	const vector<Position>& Bases() const { return bases; }
+	const vector<Position>& Hospitals() const { return hospitals; }
+	const vector<Position>& CleaningBases() const { return cleaningBases; }
+
+	int BaseSite(int base) const { return base; }
+	int HospitalSite(int hospital) const { return NbBases() + hospital; }
+	int CleaningBaseSite(int cleaningBase) const { return NbBases() + NbHospitals() + cleaningBase; }
+
+	//distances from site to every base, by base index
+	const double* ToBases(int site) const { return toBases.data() + (size_t) site * NbBases(); }
+	double HospitalToCleaningBase(int hospital, int cleaningBase) const { return hospitalsToCleaningBases[(size_t) hospital * NbCleaningBases() + cleaningBase]; }
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+
+#include "ProblemData.h"
+
+using std::string;
+
+/*
+   V instances by "usual index": the scenarios of the usual calls files, counted in a fixed order. Shared by --instance_index and InstanceConverter.
+   The instance's name is prefixed with its file's prefix
+
+   supposes the correct directory structure in dirPath
+   instance_index: valid range [0, 5039]
+
+   about timeHorizonUsage:
+   timeHorizonUsage == "" || "default" --> use predetermined default value per instance type
+   timeHorizonUsage == "infinite" --> consider "infinite" time horizon, all requests must be serviced
+   timeHorizonUsage == "value" --> use value of timeHorizon param
+*/
+bool FindVInstanceByIndex(string dirPath, int instance_index, string osmPath, ProblemData &problemData,  string timeHorizonUsage, double timeHorizon, int setNbVehicles);
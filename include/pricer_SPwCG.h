@@ -31,6 +31,8 @@
 
 #include "Params.h"
 #include "BasePricing.h"
+#include "PricingThreadPool.h"
+#include "ColumnPool.h"
 #include "ProblemData.h"
 #include "ProblemSolution.h"
 
@@ -38,6 +40,9 @@
  * Data structures
  */
 
+//greedy heuristic, label limit tiers and exact pricing
+#define MAX_PRICING_TIERS (Params::MaxHeuristicLabelLimits + 2)
+
 /** @brief Variable pricer data used in the \ref pricer_binpacking.c "pricer" */
 struct SCIP_PricerData
 {
@@ -46,21 +51,50 @@ struct SCIP_PricerData
    Params*               params;
    ProblemData*          problemData;        /**< general problem info */
    BasePricing*          pricingAlgo;        /** < implementation of pricing algorithm */
+   PricingThreadPool*    threadPool;         /** < NULL if vehicles are priced sequentially */
+   BasePricing**         workerPricingAlgos; /** < one pricing algorithm per thread in threadPool */
+   ColumnPool*           columnPool;         /** < NULL if not used */
 
-   bool heuristicPricing;
+   /*
+      pricing tiers, see Params::heuristicLabelLimits: 
+         0 is the greedy heuristic, 1 to heuristicLabelLimits.size() keep a limited number of labels per request and the last one is exact pricing.
+      Each round of pricing starts at tier 0
+   */
+   int pricingTier;
    int lastSuccessfullVehicle;
+   vector<double>*       centerAlpha;        /** < stability center of the dual smoothing (Params::dualSmoothing). Empty until the first pricing round of each node */
+   vector<double>*       centerBeta;
+   double                centerBound;        /** < Lagrangian bound at the stability center, -HUGE_VAL if none was computed there */
+   SCIP_Longint          centerNode;         /** < number of the node the stability center belongs to */
+   double                rootBestBound;      /** < best Lagrangian bound of the root node so far */
    
    // logging:
-   double                total_pricing_time; //in seconds
+   double                total_pricing_time; //in seconds. When pricing in parallel, the sum of the time spent by each thread
    int                   total_pricing_calls;
    int                   total_pricing_fails;
    int                   total_pricing_timeouts;
+   int                   total_pricing_early_exits;
    size_t labelsPriced;
    size_t labelsStored;
    size_t labelsDeleted;
+   size_t labelsPrunedByBound;
+   size_t labelsReused;
+   int incrementalPricingCalls; //answered by re-costing the labels of a previous call
+   int poolRounds; //pricing rounds answered by the column pool, without labeling
+   size_t poolColumnsAdded;
+   int mispricings; //pricing rounds with smoothed duals that found nothing useful at the LP duals
+   int rootPricingCalls;
+   double rootPricingTime;
+   double rootTime; //solving time when the root node's last pricing round ended
+   int lagrangianBounds; //pricing rounds that computed a Lagrangian bound, see Params::useLagrangianBound
+   int cgEarlyStops; //column generation stopped by Params::cgGapTolerance
+   vector<double>* rootBoundTrace; //solving time, Lagrangian bound and LP objective of each root round that improved the bound
    size_t sumOfMaxLabelsStoredSimultaneously;
    size_t sumOfMostLabelsInRequest;
    size_t sumOfNbConsideredRequests;
+   int tierRounds[MAX_PRICING_TIERS]; //pricing rounds that tried each tier
+   int tierHits[MAX_PRICING_TIERS]; //pricing rounds in which each tier found columns
+   double tierTime[MAX_PRICING_TIERS]; //time spent pricing in each tier
 
 };
 
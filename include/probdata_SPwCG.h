@@ -67,12 +67,29 @@ struct ExecutionSummary
    double total_pricing_time;
    size_t total_pricing_calls;
    size_t total_pricing_timeouts;
+   size_t total_pricing_early_exits;
    size_t totalLabelsPriced;
    size_t totalLabelsStored;
    size_t totalLabelsDeleted;
+   size_t totalLabelsPrunedByBound;
+   size_t totalLabelsReused;
+   size_t incrementalPricingCalls;
+   size_t poolRounds;
+   size_t poolColumnsAdded;
+   size_t mispricings;
+   size_t rootPricingCalls;
+   double rootPricingTime;
+   double rootTime;
+   size_t lagrangianBounds;
+   size_t cgEarlyStops;
+   vector<double> rootBoundTrace; //see SCIP_PricerData::rootBoundTrace
    size_t sumOfMaxLabelsStoredSimultaneously;
    size_t sumOfMostLabelsInRequest;
    size_t sumOfNbConsideredRequests;
+   int nbPricingTiers; //used entries of the tier arrays below, see SCIP_PricerData::pricingTier
+   int tierRounds[Params::MaxHeuristicLabelLimits + 2];
+   int tierHits[Params::MaxHeuristicLabelLimits + 2];
+   double tierTime[Params::MaxHeuristicLabelLimits + 2];
    size_t timesBranchedWithRule[3];
    size_t timesRepeatedRouteWasPriced;
    double repeatedRoutesTotalReducedCost;
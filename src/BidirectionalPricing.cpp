@@ -0,0 +1,640 @@
+#include "BidirectionalPricing.h"
+#include "RouteExpander.h"
+
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+BidirectionalPricing::BidirectionalPricing(Params *params, ProblemData* problemData) : fallback(params, problemData)
+{
+	this->problemData = problemData;
+	this->params = params;
+}
+
+double BidirectionalPricing::Evaluate(const Function &f, double t)
+{
+	if(f.nbPieces == 0 || t < f.pieces[0].start - 1e-9 || t > f.end + 1e-9) return HUGE_VAL;
+	const Piece &piece = PieceAt(f, t);
+	if(piece.value == HUGE_VAL) return HUGE_VAL;
+	return piece.value + piece.slope * (t - piece.start);
+}
+
+const BidirectionalPricing::Piece& BidirectionalPricing::PieceAt(const Function &f, double t)
+{
+	const Piece* itr = std::upper_bound(f.pieces, f.pieces + f.nbPieces, t, [](double t, const Piece &piece){ return t < piece.start; });
+	return itr == f.pieces ? f.pieces[0] : *(itr - 1);
+}
+
+void BidirectionalPricing::AppendBreakpoints(const Function &f, double lo, double hi, vector<double> &out)
+{
+	for(int p = 0; p < f.nbPieces; p++)
+	{
+		if(f.pieces[p].start >= lo && f.pieces[p].start <= hi) out.push_back(f.pieces[p].start);
+	}
+	if(f.end >= lo && f.end <= hi) out.push_back(f.end);
+}
+
+bool BidirectionalPricing::Dominates(const Function &a, const Function &b)
+{
+	double lo = b.pieces[0].start;
+	double hi = b.end;
+	if(a.pieces[0].start > lo + 1e-9 || a.end < hi - 1e-9) return false;
+
+	//most comparisons fail at the ends of the domain, check them before going through the pieces
+	for(double x : {lo, hi})
+	{
+		double vb = Evaluate(b, x);
+		if(vb != HUGE_VAL && Evaluate(a, x) >= vb + DominanceEpsilon()) return false;
+	}
+
+	//both are linear between consecutive piece starts, so comparing at the ends of each interval is enough
+	const Piece* pa = &PieceAt(a, lo);
+	const Piece* pb = b.pieces;
+	const Piece* aEnd = a.pieces + a.nbPieces;
+	const Piece* bEnd = b.pieces + b.nbPieces;
+	double s = lo;
+	while(s < hi - 1e-9)
+	{
+		while(pa + 1 != aEnd && (pa + 1)->start <= s) pa++;
+		while(pb + 1 != bEnd && (pb + 1)->start <= s) pb++;
+
+		double e = hi;
+		if(pa + 1 != aEnd) e = std::min(e, (pa + 1)->start);
+		if(pb + 1 != bEnd) e = std::min(e, (pb + 1)->start);
+
+		if(pb->value != HUGE_VAL)
+		{
+			if(pa->value == HUGE_VAL) return false;
+			for(double x : {s, e})
+			{
+				double va = pa->value + pa->slope * (x - pa->start);
+				double vb = pb->value + pb->slope * (x - pb->start);
+				if(va >= vb + DominanceEpsilon()) return false;
+			}
+		}
+		s = e;
+	}
+	return true;
+}
+
+void BidirectionalPricing::LatenessBreakpoints(int j, vector<double> &out)
+{
+	if(!problemData->useTargetWaitTimeObjective) return; //linear
+
+	//same lookup as ProblemData::weighted_lateness
+	auto itr = problemData->target_times_per_weight.lower_bound(requests[j]->weight);
+	if(itr != problemData->target_times_per_weight.end()) out.push_back(requests[j]->arrival_time + itr->second);
+}
+
+template <class F>
+bool BidirectionalPricing::BuildFunction(F f, vector<double> &breakpoints, double lo, double hi, Function &out)
+{
+	breakpoints.push_back(lo);
+	breakpoints.push_back(hi);
+	std::sort(breakpoints.begin(), breakpoints.end());
+
+	scratchPieces.clear();
+	for(size_t p = 0; p + 1 < breakpoints.size(); p++)
+	{
+		double s = breakpoints[p];
+		double e = breakpoints[p + 1];
+		if(s < lo || e > hi || e - s < 1e-9) continue;
+
+		//f is linear inside (s, e): evaluate away from the ends, where it may jump
+		double q1 = s + (e - s) / 3.0;
+		double q2 = s + 2.0 * (e - s) / 3.0;
+		double v1 = f(q1);
+		double v2 = f(q2);
+
+		Piece piece;
+		piece.start = s;
+		if(v1 == HUGE_VAL || v2 == HUGE_VAL)
+		{
+			piece.value = HUGE_VAL;
+			piece.slope = 0.0;
+		}
+		else
+		{
+			piece.slope = (v2 - v1) / (q2 - q1);
+			piece.value = v1 - piece.slope * (q1 - s);
+		}
+
+		//merge with the previous piece if it's the same line
+		if(!scratchPieces.empty())
+		{
+			const Piece &last = scratchPieces.back();
+			if(last.value == HUGE_VAL && piece.value == HUGE_VAL) continue;
+			if(last.value != HUGE_VAL && piece.value != HUGE_VAL && std::abs(last.slope - piece.slope) < 1e-9
+				&& std::abs(last.value + last.slope * (s - last.start) - piece.value) < 1e-6) continue;
+		}
+		scratchPieces.push_back(piece);
+	}
+
+	//infeasible at the ends: shrink the domain
+	double end = hi;
+	if(!scratchPieces.empty() && scratchPieces.back().value == HUGE_VAL)
+	{
+		end = scratchPieces.back().start;
+		scratchPieces.pop_back();
+	}
+	if(!scratchPieces.empty() && scratchPieces.front().value == HUGE_VAL)
+	{
+		scratchPieces.erase(scratchPieces.begin());
+	}
+	if(scratchPieces.empty()) return false;
+
+	out.pieces = scratchPieces.data();
+	out.nbPieces = scratchPieces.size();
+	out.end = end;
+	return true;
+}
+
+BidirectionalPricing::Function BidirectionalPricing::Store(const Function &f)
+{
+	Piece* pieces = static_cast<Piece*>(arena.allocate(f.nbPieces * sizeof(Piece), alignof(Piece)));
+	std::copy(f.pieces, f.pieces + f.nbPieces, pieces);
+
+	Function stored = f;
+	stored.pieces = pieces;
+	return stored;
+}
+
+const BidirectionalPricing::Function& BidirectionalPricing::ArrivalFunction(int j, int k)
+{
+	size_t e = (size_t) j * requests.size() + k;
+	if(arrivalFunctionBuilt[e]) return arrivalFunctions[e];
+	arrivalFunctionBuilt[e] = true;
+
+	double timeAvailable = problemData->getVehicle(vehicle_id)->timeAvailable;
+	int iLast = requestIndices[j];
+	int iNext = requestIndices[k];
+
+	arrivalBreakpoints.clear();
+	transitionTable->Breakpoints(iLast, iNext, timeAvailable, arrivalBreakpoints);
+
+	auto arrival = [&](double t)
+	{
+		bool feasible = false;
+		double time = HUGE_VAL;
+		int waitingStation = -1;
+		if(!transitionTable->Evaluate(iLast, iNext, t, timeAvailable, feasible, time, waitingStation) || !feasible) return HUGE_VAL;
+		return time;
+	};
+
+	double lo = std::max(midpoint, requests[j]->arrival_time);
+	Function f;
+	if(lo <= problemData->timeHorizon && BuildFunction(arrival, arrivalBreakpoints, lo, problemData->timeHorizon, f)) arrivalFunctions[e] = Store(f);
+	else arrivalFunctions[e].nbPieces = 0;
+	return arrivalFunctions[e];
+}
+
+bool BidirectionalPricing::TryAddToBestColumnsHeap(const Column &column)
+{
+	if(column.reducedCost > -params->RCEpsilon) return false;
+
+	if(bestColumnsHeap.size() < n_desired_routes)
+	{
+		bestColumnsHeap.push_back(column);
+		push_heap(bestColumnsHeap.begin(), bestColumnsHeap.end(), compLRC);
+		return true;
+	}
+	// bestColumnsHeap.front() is the worst column in bestColumnsHeap
+	//if column is better, replace it
+	else if(column.reducedCost < bestColumnsHeap.front().reducedCost)
+	{
+		pop_heap(bestColumnsHeap.begin(), bestColumnsHeap.end(), compLRC);
+		bestColumnsHeap.pop_back();
+
+		bestColumnsHeap.push_back(column);
+		push_heap(bestColumnsHeap.begin(), bestColumnsHeap.end(), compLRC);
+		return true;
+	}
+
+	return false;
+}
+
+bool BidirectionalPricing::CheckLimits(std::chrono::steady_clock::time_point alg_start)
+{
+	//if the arena exceeds 95% of max_memory,
+	if(((double)arena.BytesUsed() / 1000000) > (double) max_memory * 0.95)
+	{
+		std::cout << "memory out (" << pricing_ret.labelsStored << " labels, " << arena.BytesUsed() / 1000000 << " MB)" << std::endl;
+		return false;
+	}
+
+	if(pricing_ret.labelsPriced % 1000 == 0)
+	{
+		double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - alg_start).count();
+		if(time > max_time || params->Timeout()) return false;
+	}
+	return true;
+}
+
+bool BidirectionalPricing::BackwardLabeling(const PricingEdges& edges, std::chrono::steady_clock::time_point alg_start)
+{
+	int nbConsidered = requests.size();
+	vector<double> breakpoints;
+	vector<const BackwardLabel*> pending;
+
+	//routes ending at each request
+	for(int j = 0; j < nbConsidered; j++)
+	{
+		const Request* req = requests[j];
+		if(!problemData->IsCompatible(req, vehicle_id)) continue;
+
+		double lo = std::max(midpoint, req->arrival_time);
+		if(lo > problemData->timeHorizon) continue;
+
+		breakpoints.clear();
+		LatenessBreakpoints(j, breakpoints);
+
+		BackwardLabel label;
+		label.reqIndex = j;
+		label.nextLabel = NULL;
+		label.dominated = false;
+		auto reducedCost = [&](double t){ return problemData->weighted_lateness(req, t) - beta[j]; };
+		if(!BuildFunction(reducedCost, breakpoints, lo, problemData->timeHorizon, label.reducedCost)) continue;
+		label.reducedCost = Store(label.reducedCost);
+
+		BackwardLabel* stored = arena.New(label);
+		backwardLabels[j].push_back(stored);
+		pending.push_back(stored);
+		pricing_ret.labelsStored++;
+	}
+
+	//extend towards earlier requests, in the order labels were created
+	for(size_t p = 0; p < pending.size(); p++)
+	{
+		const BackwardLabel* label = pending[p];
+		if(label->dominated) continue;
+
+		int k = label->reqIndex;
+		const Function &next = label->reducedCost;
+
+		for(int j = 0; j < nbConsidered; j++)
+		{
+			if(j == k) continue;
+			const Request* req = requests[j];
+			if(!problemData->IsCompatible(req, vehicle_id)) continue;
+
+			//if branching rule forbids this request-to-request connection, skip it
+			if(edges.IsForbidden(requestIndices[j], requestIndices[k])) continue;
+
+			pricing_ret.labelsPriced++;
+			if(!CheckLimits(alg_start)) return false;
+
+			const Function &arrival = ArrivalFunction(j, k);
+			if(arrival.nbPieces == 0) continue;
+
+			double lo = arrival.pieces[0].start;
+			double hi = arrival.end;
+
+			breakpoints.clear();
+			LatenessBreakpoints(j, breakpoints);
+			AppendBreakpoints(arrival, lo, hi, breakpoints);
+
+			//where the arrival at k crosses a breakpoint of the suffix. Only pieces with slope 1 move the arrival
+			for(int q = 0; q < arrival.nbPieces; q++)
+			{
+				const Piece &piece = arrival.pieces[q];
+				if(piece.value == HUGE_VAL || piece.slope < 0.5) continue;
+				double pieceEnd = q + 1 < arrival.nbPieces ? arrival.pieces[q + 1].start : arrival.end;
+
+				for(int r = 0; r <= next.nbPieces; r++)
+				{
+					double x = r < next.nbPieces ? next.pieces[r].start : next.end;
+					double t = piece.start + (x - piece.value) / piece.slope;
+					if(t > piece.start && t < pieceEnd) breakpoints.push_back(t);
+				}
+			}
+
+			double edgeDual = edges.Dual(requestIndices[j], requestIndices[k]);
+			auto reducedCost = [&](double t)
+			{
+				double arrivalTime = Evaluate(arrival, t);
+				if(arrivalTime == HUGE_VAL) return HUGE_VAL;
+				double suffix = Evaluate(next, arrivalTime);
+				if(suffix == HUGE_VAL) return HUGE_VAL;
+				return problemData->weighted_lateness(req, t) - beta[j] - edgeDual + suffix;
+			};
+
+			BackwardLabel newLabel;
+			newLabel.reqIndex = j;
+			newLabel.nextLabel = label;
+			newLabel.dominated = false;
+			if(!BuildFunction(reducedCost, breakpoints, lo, hi, newLabel.reducedCost)) continue;
+
+			bool dominated = false;
+			for(const BackwardLabel* other : backwardLabels[j])
+			{
+				if(!other->dominated && Dominates(other->reducedCost, newLabel.reducedCost))
+				{
+					dominated = true;
+					break;
+				}
+			}
+			if(dominated) continue;
+
+			for(BackwardLabel* other : backwardLabels[j])
+			{
+				if(!other->dominated && Dominates(newLabel.reducedCost, other->reducedCost))
+				{
+					other->dominated = true;
+					pricing_ret.labelsDeleted++;
+				}
+			}
+
+			newLabel.reducedCost = Store(newLabel.reducedCost);
+			BackwardLabel* stored = arena.New(newLabel);
+			backwardLabels[j].push_back(stored);
+			pending.push_back(stored);
+			pricing_ret.labelsStored++;
+		}
+	}
+
+	return true;
+}
+
+void BidirectionalPricing::Join(const ForwardLabel* forward, int j, double time, double reducedCost)
+{
+	for(const BackwardLabel* backward : backwardLabels[j])
+	{
+		if(backward->dominated) continue;
+
+		double suffix = Evaluate(backward->reducedCost, time);
+		if(suffix == HUGE_VAL) continue;
+
+		Column column;
+		column.forward = forward;
+		column.backward = backward;
+		column.joinTime = time;
+		column.reducedCost = reducedCost + suffix;
+		TryAddToBestColumnsHeap(column);
+	}
+}
+
+bool BidirectionalPricing::TryAddForwardLabel(const ForwardLabel &label)
+{
+	if(params->AllowsPositiveRCElimination(problemData->waitingStationPolicy) && label.reducedCost > -params->RCEpsilon) return false;
+
+	ForwardLabel* stored = arena.New(label);
+
+	Column column;
+	column.forward = stored;
+	column.backward = NULL;
+	column.joinTime = 0.0;
+	column.reducedCost = label.reducedCost;
+	TryAddToBestColumnsHeap(column);
+
+	//every label already expanded at this request is earlier, so if any of them is better this one is dominated
+	if(label.reducedCost + DominanceEpsilon() > bestExpandedRC[label.reqIndex]) return false;
+
+	queue.push_back(stored);
+	push_heap(queue.begin(), queue.end(), CompForwardOrder());
+
+	pricing_ret.labelsStored++;
+	return true;
+}
+
+bool BidirectionalPricing::ForwardLabeling(double alpha_dual, const PricingEdges& edges, std::chrono::steady_clock::time_point alg_start)
+{
+	int nbConsidered = requests.size();
+	const Vehicle* vehicle = problemData->getVehicle(vehicle_id);
+	RouteExpander routeExpander(params);
+
+	bestExpandedRC.assign(nbConsidered, HUGE_VAL);
+
+	//initial labels, leaving the vehicle's initial position
+	for (int i = 0; i < nbConsidered; i++)
+	{
+		const Request* nextReq = requests[i];
+
+		double newTime;
+		int waitingStation;
+		bool useIntermediate;
+		IntermediateVertex intermediateVertex;
+		bool ret = routeExpander.checkRouteExpansion(problemData, vehicle_id, nextReq, problemData->GetInitialPosition(vehicle_id), vehicle->timeAvailable, newTime, waitingStation, useIntermediate, intermediateVertex);
+		pricing_ret.labelsPriced++;
+
+		if (!ret || newTime > problemData->timeHorizon) continue;
+
+		if(newTime > midpoint)
+		{
+			Join(NULL, i, newTime, -alpha_dual);
+			continue;
+		}
+
+		ForwardLabel label;
+		label.reqIndex = i;
+		label.reducedCost = problemData->weighted_lateness(nextReq, newTime) - alpha_dual - beta[i];
+		label.time = newTime;
+		label.lastWaitingStation = useIntermediate ? -1 : waitingStation;
+		label.intermediatePosition = useIntermediate ? arena.New(intermediateVertex) : NULL;
+		label.lastLabel = NULL;
+
+		TryAddForwardLabel(label);
+	}
+
+	//label setting, in increasing time order. Every queued label is before the midpoint
+	while(!queue.empty())
+	{
+		pop_heap(queue.begin(), queue.end(), CompForwardOrder());
+		const ForwardLabel* label = queue.back();
+		queue.pop_back();
+
+		int i = label->reqIndex;
+		const Request* req = requests[i];
+
+		//a better label may have been expanded since this one was queued
+		if(label->reducedCost + DominanceEpsilon() > bestExpandedRC[i])
+		{
+			pricing_ret.labelsDeleted++;
+			continue;
+		}
+		bestExpandedRC[i] = label->reducedCost;
+
+		for(int j = 0; j < nbConsidered; j++)
+		{
+			if(i == j) continue;
+			const Request* nextReq = requests[j];
+			int iNextReq = requestIndices[j];
+
+			//if branching rule forbids this request-to-request connection, skip it
+			if(edges.IsForbidden(requestIndices[i], iNextReq)) continue;
+
+			double newTime = 0.0;
+			int waitingStation = -1;
+			bool useIntermediate = false;
+			IntermediateVertex intermediateVertex = IntermediateVertex();
+			bool ret = routeExpander.checkRequestExpansion(problemData, transitionTable, vehicle_id, nextReq, iNextReq, req, requestIndices[i], label->time, newTime, waitingStation, useIntermediate, intermediateVertex);
+			pricing_ret.labelsPriced++;
+
+			if(!CheckLimits(alg_start)) return false;
+
+			if (!ret) continue;
+
+			double reducedCost = label->reducedCost - edges.Dual(requestIndices[i], iNextReq);
+
+			if(newTime > midpoint)
+			{
+				Join(label, j, newTime, reducedCost);
+				continue;
+			}
+
+			ForwardLabel newLabel;
+			newLabel.reqIndex = j;
+			newLabel.reducedCost = reducedCost + problemData->weighted_lateness(nextReq, newTime) - beta[j];
+			newLabel.time = newTime;
+			newLabel.lastWaitingStation = useIntermediate ? -1 : waitingStation;
+			newLabel.intermediatePosition = useIntermediate ? arena.New(intermediateVertex) : NULL;
+			newLabel.lastLabel = label;
+
+			TryAddForwardLabel(newLabel);
+		}
+	}
+
+	return true;
+}
+
+bool BidirectionalPricing::BuildRoute(const Column &column, Route &route)
+{
+	route.veh_index = vehicle_id;
+
+	//forward part, in reverse:
+	for(const ForwardLabel* label = column.forward; label != NULL; label = label->lastLabel)
+	{
+		route.vertices.push_back(*requests[label->reqIndex]);
+
+		assert(!(label->intermediatePosition != NULL && label->lastWaitingStation != -1));
+
+		if(label->intermediatePosition != NULL)
+		{
+			assert(label->intermediatePosition->id == -1);
+			route.intermediates.push_back(*label->intermediatePosition);
+			route.vertices.push_back((Vertex) *label->intermediatePosition);
+		}
+		if (label->lastWaitingStation != -1) { //if this transition stops at a waiting station...
+			const WaitingStation* ws = problemData->GetWaitingStation(label->lastWaitingStation);
+			route.vertices.push_back(*ws); //add waiting station
+		}
+	}
+
+	//insert source vertex
+	route.vertices.push_back(*problemData->GetInitialPosition(vehicle_id));
+
+	//reverse entire route
+	std::reverse(route.vertices.begin(), route.vertices.end());
+	std::reverse(route.intermediates.begin(), route.intermediates.end());
+
+	//backward part: waiting stations depend on the actual times, so expand it again from the join
+	RouteExpander routeExpander(params);
+	int iLast = column.forward != NULL ? column.forward->reqIndex : -1;
+	double lastTime = column.forward != NULL ? column.forward->time : problemData->getVehicle(vehicle_id)->timeAvailable;
+	for(const BackwardLabel* label = column.backward; label != NULL; label = label->nextLabel)
+	{
+		int j = label->reqIndex;
+
+		double newTime = 0.0;
+		int waitingStation = -1;
+		bool useIntermediate = false;
+		IntermediateVertex intermediateVertex = IntermediateVertex();
+		bool ret;
+		if(iLast < 0) ret = routeExpander.checkRouteExpansion(problemData, vehicle_id, requests[j], problemData->GetInitialPosition(vehicle_id), lastTime, newTime, waitingStation, useIntermediate, intermediateVertex);
+		else ret = routeExpander.checkRequestExpansion(problemData, transitionTable, vehicle_id, requests[j], requestIndices[j], requests[iLast], requestIndices[iLast], lastTime, newTime, waitingStation, useIntermediate, intermediateVertex);
+		if(!ret) return false;
+
+		if(useIntermediate)
+		{
+			route.intermediates.push_back(intermediateVertex);
+			route.vertices.push_back((Vertex) intermediateVertex);
+		}
+		else if(waitingStation != -1)
+		{
+			route.vertices.push_back(*problemData->GetWaitingStation(waitingStation));
+		}
+		route.vertices.push_back(*requests[j]);
+
+		iLast = j;
+		lastTime = newTime;
+	}
+
+	route.SetArrivalsAndDepartures(problemData);
+	route.UpdateCost(problemData);
+	return true;
+}
+
+void BidirectionalPricing::Cleanup()
+{
+	queue.clear();
+	bestColumnsHeap.clear();
+	backwardLabels.clear();
+	arrivalFunctions.clear();
+	arrivalFunctionBuilt.clear();
+
+	arena.Reset();
+}
+
+PricingReturn BidirectionalPricing::Price(int vehicle_id, int n_routes, vector<double>& alpha_duals, vector<double>& beta_duals, vector<Route>& outRoutes, vector<int> consideredRequests, const PricingEdges& edges)
+{
+	assert((int) alpha_duals.size() == problemData->NbVehicles());
+	assert((int) beta_duals.size() == problemData->NbRequests());
+	assert(consideredRequests.size() > 0);
+
+	transitionTable = problemData->GetTransitionTable(); //may be NULL
+	if(transitionTable == NULL || problemData->allowRerouting)
+	{
+		fallback.SetMaxTime(max_time);
+		fallback.SetMaxMemory(max_memory);
+		return fallback.Price(vehicle_id, n_routes, alpha_duals, beta_duals, outRoutes, consideredRequests, edges);
+	}
+
+	pricing_ret = PricingReturn();
+	pricing_ret.nbConsideredRequests = consideredRequests.size();
+
+	auto alg_start = std::chrono::steady_clock::now();
+
+	Cleanup();
+
+	this->vehicle_id = vehicle_id;
+	this->n_desired_routes = n_routes;
+
+	const Vehicle* vehicle = problemData->getVehicle(vehicle_id);
+	midpoint = vehicle->timeAvailable + params->bidirectionalMidpoint * (problemData->timeHorizon - vehicle->timeAvailable);
+
+	int nbConsidered = consideredRequests.size();
+	requests.resize(nbConsidered);
+	requestIndices.resize(nbConsidered);
+	beta.resize(nbConsidered);
+	for (int i = 0; i < nbConsidered; i++)
+	{
+		requests[i] = problemData->GetRequest(consideredRequests[i]);
+		requestIndices[i] = problemData->RequestIdToIndex(consideredRequests[i]);
+		beta[i] = beta_duals[requestIndices[i]];
+	}
+
+	arrivalFunctions.assign((size_t) nbConsidered * nbConsidered, Function());
+	arrivalFunctionBuilt.assign((size_t) nbConsidered * nbConsidered, false);
+	backwardLabels.resize(nbConsidered);
+
+	bool timeout = !BackwardLabeling(edges, alg_start);
+	if(!timeout) timeout = !ForwardLabeling(alpha_duals[vehicle_id], edges, alg_start);
+
+	pricing_ret.maxLabelsStoredSimultaneously = pricing_ret.labelsStored; //nothing is freed during the call
+	pricing_ret.mostLabelsInRequest = 0;
+	for(const vector<BackwardLabel*> &labels : backwardLabels) pricing_ret.mostLabelsInRequest = std::max(pricing_ret.mostLabelsInRequest, labels.size());
+	pricing_ret.timeout = timeout;
+
+	outRoutes.clear();
+	for (const Column &column : bestColumnsHeap)
+	{
+		Route route;
+		if(!BuildRoute(column, route)) continue;
+		outRoutes.push_back(route);
+		pricing_ret.reducedCostPerRoute.push_back(column.reducedCost);
+	}
+
+	Cleanup();
+	pricing_ret.status = outRoutes.empty() ? PricingReturnStatus::FAIL : PricingReturnStatus::OK;
+	return pricing_ret;
+}
@@ -0,0 +1,257 @@
+#include "CallFile.h"
+
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <charconv>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//index file layout: IndexHeader, then nbScenarios offsets
+struct IndexHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t complete;
+	uint64_t fileSize;
+	int64_t modificationTime[2];
+	uint64_t nbScenarios;
+};
+static const char indexMagic[8] = {'S', 'A', 'V', 'R', 'P', 'I', 'D', '\0'};
+static const uint32_t indexVersion = 1;
+
+static bool IsSpace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+//end of the line starting at p, the '\n' or end
+static const char* LineEnd(const char* p, const char* end)
+{
+	const char* newline = static_cast<const char*>(memchr(p, '\n', end - p));
+	return newline != NULL ? newline : end;
+}
+
+static const char* NextLine(const char* lineEnd, const char* end)
+{
+	return lineEnd < end ? lineEnd + 1 : end;
+}
+
+//reads the next whitespace separated number of [p, end) and moves p after it, as istream's >> would
+template <class T>
+static bool ReadNumber(const char* &p, const char* end, T &out)
+{
+	while(p < end && IsSpace(*p)) p++;
+	if(p < end && *p == '+') p++;
+	std::from_chars_result result = std::from_chars(p, end, out);
+	if(result.ec != std::errc()) return false;
+	p = result.ptr;
+	return true;
+}
+
+CallFile::CallFile(string path) : path(path), size(0), complete(true)
+{
+	int fd = open(path.c_str(), O_RDONLY);
+	if(fd < 0) throw std::invalid_argument("file not found : " + path);
+
+	struct stat st;
+	if(fstat(fd, &st) != 0)
+	{
+		close(fd);
+		throw std::invalid_argument("file not found : " + path);
+	}
+	size = st.st_size;
+	modificationTime[0] = st.st_mtim.tv_sec;
+	modificationTime[1] = st.st_mtim.tv_nsec;
+
+	//empty files can't be mapped, and have no scenarios anyway
+	if(size > 0)
+	{
+		void* mapped = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+		if(mapped == MAP_FAILED)
+		{
+			close(fd);
+			throw std::invalid_argument("could not map file : " + path);
+		}
+		size_t length = size;
+		mapping = std::shared_ptr<const void>(mapped, [length](const void* p) { munmap(const_cast<void*>(p), length); });
+	}
+	//the mapping stays valid after closing
+	close(fd);
+
+	if(LoadIndex()) return;
+
+	BuildIndex();
+	try
+	{
+		StoreIndex();
+	}
+	catch(std::exception &e)
+	{
+		std::cout << "WARNING: call file index: " << e.what() << std::endl;
+	}
+}
+
+std::shared_ptr<const CallFile> CallFile::Open(string path)
+{
+	static std::mutex mutex;
+	static std::map<string, std::shared_ptr<const CallFile>> files;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	auto found = files.find(path);
+	struct stat st;
+	if(found != files.end() && stat(path.c_str(), &st) == 0 && (size_t) st.st_size == found->second->size
+		&& st.st_mtim.tv_sec == found->second->modificationTime[0] && st.st_mtim.tv_nsec == found->second->modificationTime[1])
+	{
+		return found->second;
+	}
+
+	std::shared_ptr<const CallFile> file = std::make_shared<const CallFile>(path);
+	files[path] = file;
+	return file;
+}
+
+void CallFile::BuildIndex()
+{
+	const char* begin = static_cast<const char*>(mapping.get());
+	const char* end = begin + size;
+
+	offsets.clear();
+	complete = true;
+	const char* p = begin;
+	while(p < end)
+	{
+		const char* lineEnd = LineEnd(p, end);
+		const char* q = p;
+		int nbCalls;
+		if(!ReadNumber(q, lineEnd, nbCalls) || nbCalls < 0)
+		{
+			//blank lines at the end of the file are fine
+			while(q < end && (IsSpace(*q) || *q == '\n')) q++;
+			complete = q == end;
+			return;
+		}
+
+		const char* next = NextLine(lineEnd, end);
+		for(int i = 0; i < nbCalls; i++)
+		{
+			if(next == end)
+			{
+				//missing calls
+				complete = false;
+				return;
+			}
+			next = NextLine(LineEnd(next, end), end);
+		}
+
+		offsets.push_back(p - begin);
+		p = next;
+	}
+}
+
+bool CallFile::LoadIndex()
+{
+	FILE* file = fopen((path + ".index").c_str(), "rb");
+	if(file == NULL) return false;
+
+	IndexHeader header;
+	bool ok = fread(&header, sizeof(header), 1, file) == 1 && memcmp(header.magic, indexMagic, sizeof(indexMagic)) == 0
+		&& header.version == indexVersion && header.fileSize == size
+		&& header.modificationTime[0] == modificationTime[0] && header.modificationTime[1] == modificationTime[1]
+		&& header.nbScenarios <= size;
+	if(ok)
+	{
+		offsets.resize(header.nbScenarios);
+		ok = fread(offsets.data(), sizeof(uint64_t), offsets.size(), file) == offsets.size();
+	}
+	fclose(file);
+
+	//offsets must be increasing and inside the file
+	for(size_t k = 0; ok && k < offsets.size(); k++) ok = offsets[k] < size && (k == 0 || offsets[k] > offsets[k - 1]);
+	if(!ok)
+	{
+		offsets.clear();
+		return false;
+	}
+	complete = header.complete != 0;
+	return true;
+}
+
+void CallFile::StoreIndex() const
+{
+	IndexHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, indexMagic, sizeof(indexMagic));
+	header.version = indexVersion;
+	header.complete = complete;
+	header.fileSize = size;
+	header.modificationTime[0] = modificationTime[0];
+	header.modificationTime[1] = modificationTime[1];
+	header.nbScenarios = offsets.size();
+
+	//written under a temporary name and renamed, so that other processes never read a partial index
+	string indexPath = path + ".index";
+	string temporary = indexPath + ".tmp" + std::to_string(getpid());
+	FILE* file = fopen(temporary.c_str(), "wb");
+	if(file == NULL) throw std::runtime_error("could not write " + temporary);
+	bool ok = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(offsets.data(), sizeof(uint64_t), offsets.size(), file) == offsets.size();
+	ok = fclose(file) == 0 && ok;
+	if(!ok || rename(temporary.c_str(), indexPath.c_str()) != 0)
+	{
+		remove(temporary.c_str());
+		throw std::runtime_error("could not write " + indexPath);
+	}
+}
+
+vector<Call> CallFile::Scenario(int index, bool tenColumns) const
+{
+	assert(index >= 0 && index < NbScenarios());
+	const char* begin = static_cast<const char*>(mapping.get());
+	const char* end = begin + size;
+
+	const char* p = begin + offsets[index];
+	const char* lineEnd = LineEnd(p, end);
+	int nbCalls;
+	if(!ReadNumber(p, lineEnd, nbCalls) || nbCalls < 0) throw std::invalid_argument("unexpected file format");
+	p = NextLine(lineEnd, end);
+
+	vector<Call> calls(nbCalls);
+	for(Call &call : calls)
+	{
+		if(p == end) throw std::invalid_argument("unexpected file format : missing line");
+		lineEnd = LineEnd(p, end);
+
+		bool ok;
+		if(!tenColumns)
+		{
+			//Time - Region index - Priority - Day - Time on scene - Lat - Long - Time at hospital - TimeCleaningBase - Cleaning needed - Hospital needed - index hospital - index_cleaning
+			ok = ReadNumber(p, lineEnd, call.time) && ReadNumber(p, lineEnd, call.regionIndex) && ReadNumber(p, lineEnd, call.priority)
+				&& ReadNumber(p, lineEnd, call.day) && ReadNumber(p, lineEnd, call.timeOnScene) && ReadNumber(p, lineEnd, call.lat)
+				&& ReadNumber(p, lineEnd, call.lon) && ReadNumber(p, lineEnd, call.timeAtHospital) && ReadNumber(p, lineEnd, call.timeCleaningBase)
+				&& ReadNumber(p, lineEnd, call.cleaningNeeded) && ReadNumber(p, lineEnd, call.hospitalNeeded) && ReadNumber(p, lineEnd, call.indexHospital)
+				&& ReadNumber(p, lineEnd, call.indexCleaning);
+		}
+		else
+		{
+			//Time Lat Long Priority Cleaning_needed Cleaning_time Index hospital Time_on_scene Hospital needed Time at hospital
+			//(read as long, lat, as it always was)
+			call.regionIndex = 0.0;
+			call.day = 0.0;
+			call.indexCleaning = 0.0;
+			ok = ReadNumber(p, lineEnd, call.time) && ReadNumber(p, lineEnd, call.lon) && ReadNumber(p, lineEnd, call.lat)
+				&& ReadNumber(p, lineEnd, call.priority) && ReadNumber(p, lineEnd, call.cleaningNeeded) && ReadNumber(p, lineEnd, call.timeCleaningBase)
+				&& ReadNumber(p, lineEnd, call.indexHospital) && ReadNumber(p, lineEnd, call.timeOnScene) && ReadNumber(p, lineEnd, call.hospitalNeeded)
+				&& ReadNumber(p, lineEnd, call.timeAtHospital);
+		}
+		if(!ok) throw std::invalid_argument("unexpected file format : misread line data");
+
+		p = NextLine(lineEnd, end);
+	}
+	return calls;
+}
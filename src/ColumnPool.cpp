@@ -0,0 +1,98 @@
+#include "ColumnPool.h"
+
+#include <algorithm>
+#include <assert.h>
+
+void ColumnPool::Add(ProblemData* problemData, const Route& route)
+{
+	if(maxSize == 0) return;
+	if(costs.size() >= maxSize) Compact(maxSize * 3 / 4);
+
+	routes.push_back(route);
+	vehicles.push_back(route.veh_index);
+	costs.push_back(route.total_lateness);
+	for(const Vertex& vertex : route.vertices)
+	{
+		if(problemData->IsRequest(vertex.id)) requests.push_back(problemData->RequestIdToIndex(vertex.id));
+	}
+	requestsBegin.push_back(requests.size());
+	ages.push_back(0);
+}
+
+void ColumnPool::Scan(const vector<double>& alpha_duals, const vector<double>& beta_duals, const PricingEdges& edges, double rcEpsilon, vector<pair<double, int>>& out)
+{
+	Compact(maxSize);
+
+	for(int e = 0; e < (int) costs.size(); e++)
+	{
+		int begin = requestsBegin[e];
+		int end = requestsBegin[e + 1];
+
+		double reducedCost = costs[e] - alpha_duals[vehicles[e]];
+		bool forbidden = false;
+		for(int k = begin; k < end; k++)
+		{
+			reducedCost -= beta_duals[requests[k]];
+			if(k > begin)
+			{
+				reducedCost -= edges.Dual(requests[k - 1], requests[k]);
+				forbidden = forbidden || edges.IsForbidden(requests[k - 1], requests[k]);
+			}
+		}
+
+		if(!forbidden && reducedCost < -rcEpsilon)
+		{
+			ages[e] = 0;
+			out.push_back(std::make_pair(reducedCost, e));
+		}
+		else ages[e]++;
+	}
+}
+
+void ColumnPool::Compact(size_t keep)
+{
+	//youngest entries are kept. Of those at the threshold age, the earliest ones
+	int threshold = maxAge + 1;
+	size_t atThreshold = costs.size();
+	if(costs.size() > keep)
+	{
+		vector<int> sortedAges = ages;
+		std::nth_element(sortedAges.begin(), sortedAges.begin() + keep, sortedAges.end());
+		threshold = std::min(threshold, sortedAges[keep]);
+		atThreshold = keep - std::count_if(ages.begin(), ages.end(), [threshold](int age){ return age < threshold; });
+	}
+
+	int kept = 0;
+	int keptRequests = 0;
+	for(int e = 0; e < (int) costs.size(); e++)
+	{
+		if(ages[e] > threshold || ages[e] > maxAge) continue;
+		if(ages[e] == threshold)
+		{
+			if(atThreshold == 0) continue;
+			atThreshold--;
+		}
+
+		int begin = requestsBegin[e];
+		int end = requestsBegin[e + 1];
+		if(kept != e)
+		{
+			routes[kept] = std::move(routes[e]);
+			vehicles[kept] = vehicles[e];
+			costs[kept] = costs[e];
+			ages[kept] = ages[e];
+			std::copy(requests.begin() + begin, requests.begin() + end, requests.begin() + keptRequests);
+		}
+		requestsBegin[kept] = keptRequests;
+		keptRequests += end - begin;
+		kept++;
+	}
+
+	routes.resize(kept);
+	vehicles.resize(kept);
+	costs.resize(kept);
+	ages.resize(kept);
+	requests.resize(keptRequests);
+	requestsBegin.resize(kept + 1);
+	requestsBegin[kept] = keptRequests;
+}
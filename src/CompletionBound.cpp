@@ -0,0 +1,112 @@
+#include "CompletionBound.h"
+
+#include <assert.h>
+
+void CompletionBound::Build(ProblemData* problemData, int vehicle_id, const vector<int>& consideredRequests, const vector<double>& beta_duals, const PricingEdges& edges, int maxBuckets)
+{
+	valid = false;
+	nbConsidered = consideredRequests.size();
+	if(nbConsidered == 0 || maxBuckets <= 0) return;
+
+	vector<const Request*> requests(nbConsidered);
+	vector<int> requestIndices(nbConsidered);
+	vector<double> minDuration(nbConsidered); //service and trip to destination: no expansion from the request is faster than this
+	double shortestDuration = HUGE_VAL;
+	for(int i = 0; i < nbConsidered; i++)
+	{
+		requests[i] = problemData->GetRequest(consideredRequests[i]);
+		requestIndices[i] = problemData->RequestIdToIndex(consideredRequests[i]);
+		minDuration[i] = requests[i]->service_time + problemData->Distance(requests[i]->id, requests[i]->destination);
+		shortestDuration = std::min(shortestDuration, minDuration[i]);
+	}
+
+	//labels are never earlier than the vehicle's availability nor than the call of their request
+	startTime = problemData->getVehicle(vehicle_id)->timeAvailable;
+	for(int i = 0; i < nbConsidered; i++) startTime = std::min(startTime, requests[i]->arrival_time);
+	double range = problemData->timeHorizon - startTime;
+
+	//time must advance for the bound to be finite (routes are not elementary)
+	if(shortestDuration <= 1e-6 || range <= 0.0) return;
+
+	nbBuckets = (int) std::min((double) maxBuckets, std::ceil(range / shortestDuration));
+	nbBuckets = std::max(nbBuckets, 1);
+	bucketWidth = range / nbBuckets;
+
+	//a route can only expand this many times while staying inside a bucket
+	int maxStepsInBucket = (int) std::ceil(bucketWidth / shortestDuration);
+
+	bound.assign((size_t) nbBuckets * nbConsidered, 0.0);
+
+	//expansions from the start of the current bucket: reduced cost added and arrival bucket (-1 if not possible)
+	vector<double> expansionRC((size_t) nbConsidered * nbConsidered);
+	vector<int> expansionBucket((size_t) nbConsidered * nbConsidered);
+	vector<double> initial(nbConsidered);
+	vector<double> current(nbConsidered);
+
+	for(int b = nbBuckets - 1; b >= 0; b--)
+	{
+		double bucketStart = startTime + b * bucketWidth;
+		double* boundB = &bound[(size_t) b * nbConsidered];
+		const double* boundNext = b + 1 < nbBuckets ? &bound[(size_t) (b + 1) * nbConsidered] : NULL; //NULL -> 0.0, nothing left to do
+
+		for(int j = 0; j < nbConsidered; j++)
+		{
+			for(int k = 0; k < nbConsidered; k++)
+			{
+				size_t e = (size_t) j * nbConsidered + k;
+				expansionBucket[e] = -1;
+
+				if(j == k) continue;
+				if(!problemData->IsCompatible(requests[k], vehicle_id)) continue;
+				if(edges.IsForbidden(requestIndices[j], requestIndices[k])) continue;
+
+				double arrival = std::max(bucketStart + minDuration[j], requests[k]->arrival_time);
+				if(arrival > problemData->timeHorizon) continue;
+
+				expansionRC[e] = problemData->weighted_lateness(requests[k], arrival) - beta_duals[requestIndices[k]] - edges.Dual(requestIndices[j], requestIndices[k]);
+				expansionBucket[e] = std::max(Bucket(arrival), b);
+			}
+		}
+
+		//expansions leaving the bucket only depend on later buckets.
+		//Expansions arriving in this bucket may actually arrive later, so the next bucket is also a valid bound for them
+		for(int j = 0; j < nbConsidered; j++)
+		{
+			double best = boundNext ? boundNext[j] : 0.0; //the label may also be later than this bucket
+			for(int k = 0; k < nbConsidered; k++)
+			{
+				size_t e = (size_t) j * nbConsidered + k;
+				int bk = expansionBucket[e];
+				if(bk < 0) continue;
+
+				if(bk > b) best = std::min(best, expansionRC[e] + bound[(size_t) bk * nbConsidered + k]);
+				else best = std::min(best, expansionRC[e] + (boundNext ? boundNext[k] : 0.0));
+			}
+			initial[j] = best;
+		}
+		current = initial;
+
+		//expansions that stay in the bucket: relax until no route could have more steps inside it
+		for(int step = 0; step < maxStepsInBucket; step++)
+		{
+			bool changed = false;
+			for(int j = 0; j < nbConsidered; j++)
+			{
+				double best = initial[j];
+				for(int k = 0; k < nbConsidered; k++)
+				{
+					size_t e = (size_t) j * nbConsidered + k;
+					if(expansionBucket[e] != b) continue;
+					best = std::min(best, expansionRC[e] + current[k]);
+				}
+				if(best < current[j]) changed = true;
+				current[j] = best;
+			}
+			if(!changed) break;
+		}
+
+		for(int j = 0; j < nbConsidered; j++) boundB[j] = std::min(0.0, current[j]);
+	}
+
+	valid = true;
+}
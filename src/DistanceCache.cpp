@@ -0,0 +1,190 @@
+#include "DistanceCache.h"
+
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <boost/filesystem.hpp>
+
+//file layout: FileHeader, the inputs at headerSize, then the matrix data at DataOffset(inputBytes)
+struct FileHeader
+{
+	char magic[8];
+	uint32_t version;
+	int32_t nbVehicles;
+	int32_t nbRequests;
+	int32_t nbWaitingStations;
+	uint64_t key;
+	uint64_t inputBytes;
+	uint64_t bytes;
+};
+static const char fileMagic[8] = {'S', 'A', 'V', 'R', 'P', 'D', 'M', '\0'};
+static const uint32_t fileVersion = 2; //bump whenever DistanceMatrix's layout or the file layout changes
+static const size_t headerSize = 64;
+static_assert(sizeof(FileHeader) <= headerSize, "header overlaps the inputs");
+
+//the data is 64 bytes aligned
+static size_t DataOffset(size_t inputBytes)
+{
+	return headerSize + (inputBytes + 63) / 64 * 64;
+}
+
+// flock on a file, released when going out of scope
+class FileLock
+{
+	int fd;
+public:
+	explicit FileLock(const string &path)
+	{
+		fd = open(path.c_str(), O_RDWR | O_CREAT, 0666);
+		if(fd < 0) throw std::runtime_error("could not open " + path);
+		if(flock(fd, LOCK_EX) != 0)
+		{
+			close(fd);
+			throw std::runtime_error("could not lock " + path);
+		}
+	}
+	~FileLock()
+	{
+		flock(fd, LOCK_UN);
+		close(fd);
+	}
+	FileLock(const FileLock&) = delete;
+	FileLock& operator=(const FileLock&) = delete;
+};
+
+uint64_t DistanceCache::Hash(const void* data, size_t bytes, uint64_t seed)
+{
+	const unsigned char* p = static_cast<const unsigned char*>(data);
+	for(size_t i = 0; i < bytes; i++)
+	{
+		seed ^= p[i];
+		seed *= 1099511628211ULL;
+	}
+	return seed;
+}
+
+string DistanceCache::PathOf(uint64_t key, const char* extension) const
+{
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx", (unsigned long long) key);
+	return (boost::filesystem::path(directory) / (string(name) + extension)).string();
+}
+
+bool DistanceCache::Load(uint64_t key, const string &inputs, int nbVehicles, int nbRequests, int nbWaitingStations, DistanceMatrix &outMatrix) const
+{
+	int fd = open(PathOf(key, ".dist").c_str(), O_RDONLY);
+	if(fd < 0) return false;
+
+	struct stat st;
+	void* mapped = MAP_FAILED;
+	if(fstat(fd, &st) == 0 && st.st_size > (off_t) headerSize) mapped = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	//the mapping stays valid after closing
+	close(fd);
+	if(mapped == MAP_FAILED) return false;
+
+	size_t length = st.st_size;
+	std::shared_ptr<const void> file(mapped, [length](const void* p) { munmap(const_cast<void*>(p), length); });
+
+	const FileHeader* header = static_cast<const FileHeader*>(mapped);
+	const char* fileInputs = static_cast<const char*>(mapped) + headerSize;
+	if(memcmp(header->magic, fileMagic, sizeof(fileMagic)) != 0 || header->version != fileVersion || header->key != key
+		|| header->nbVehicles != nbVehicles || header->nbRequests != nbRequests || header->nbWaitingStations != nbWaitingStations
+		|| header->inputBytes != inputs.size() || DataOffset(inputs.size()) > length || header->bytes != length - DataOffset(inputs.size())
+		|| memcmp(fileInputs, inputs.data(), inputs.size()) != 0) return false;
+
+	//shares ownership of the whole mapping, points to the data
+	std::shared_ptr<const void> data(file, static_cast<const char*>(mapped) + DataOffset(inputs.size()));
+	try
+	{
+		outMatrix = DistanceMatrix::FromBuffer(nbVehicles, nbRequests, nbWaitingStations, data, header->bytes);
+	}
+	catch(std::invalid_argument&)
+	{
+		return false;
+	}
+	return true;
+}
+
+void DistanceCache::Store(uint64_t key, const string &inputs, const DistanceMatrix &matrix) const
+{
+	assert(matrix.Precision() == DistancePrecision::float64);
+
+	FileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, fileMagic, sizeof(fileMagic));
+	header.version = fileVersion;
+	header.nbVehicles = matrix.NbVehicles();
+	header.nbRequests = matrix.NbRequests();
+	header.nbWaitingStations = matrix.NbWaitingStations();
+	header.key = key;
+	header.inputBytes = inputs.size();
+	header.bytes = matrix.MemoryUsage();
+
+	//header and inputs, padded up to the data
+	vector<char> padded(DataOffset(inputs.size()), 0);
+	memcpy(padded.data(), &header, sizeof(header));
+	memcpy(padded.data() + headerSize, inputs.data(), inputs.size());
+
+	string path = PathOf(key, ".dist");
+	string temporary = path + ".tmp" + std::to_string(getpid());
+	FILE* file = fopen(temporary.c_str(), "wb");
+	if(file == NULL) throw std::runtime_error("could not write " + temporary);
+	bool ok = fwrite(padded.data(), 1, padded.size(), file) == padded.size() && fwrite(matrix.Data(), 1, header.bytes, file) == header.bytes;
+	ok = fclose(file) == 0 && ok;
+	if(!ok || rename(temporary.c_str(), path.c_str()) != 0)
+	{
+		remove(temporary.c_str());
+		throw std::runtime_error("could not write " + path);
+	}
+}
+
+DistanceMatrix DistanceCache::GetOrBuild(const string &inputs, int nbVehicles, int nbRequests, int nbWaitingStations, const std::function<DistanceMatrix()> &build) const
+{
+	uint64_t key = Hash(inputs.data(), inputs.size());
+	DistanceMatrix matrix;
+	if(Load(key, inputs, nbVehicles, nbRequests, nbWaitingStations, matrix)) return matrix;
+
+	std::unique_ptr<FileLock> lock;
+	try
+	{
+		boost::filesystem::create_directories(directory);
+		lock = std::make_unique<FileLock>(PathOf(key, ".lock"));
+
+		//someone else may have built it while we waited for the lock
+		if(Load(key, inputs, nbVehicles, nbRequests, nbWaitingStations, matrix)) return matrix;
+	}
+	catch(std::exception &e)
+	{
+		std::cout << "WARNING: distance cache: " << e.what() << std::endl;
+	}
+
+	matrix = build();
+	assert(matrix.NbVertices() == nbVehicles + 2 * nbRequests + nbWaitingStations);
+
+	if(lock)
+	{
+		try
+		{
+			Store(key, inputs, matrix);
+			//the mapped file replaces the built matrix, so its pages are shared and the heap copy is freed
+			Load(key, inputs, nbVehicles, nbRequests, nbWaitingStations, matrix);
+
+			//still locked: processes waiting for the lock find the file when they get it, later ones find it before locking
+			remove(PathOf(key, ".lock").c_str());
+		}
+		catch(std::exception &e)
+		{
+			std::cout << "WARNING: distance cache: " << e.what() << std::endl;
+		}
+	}
+	return matrix;
+}
@@ -0,0 +1,100 @@
+#include "GeodesicKernel.h"
+
+#include <cmath>
+#include <algorithm>
+#include <assert.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+//asin(s) = s + s^3 P(s^2) for s in [0, 0.5], Chebyshev fit with a relative error below 3e-15 on P
+static const double asinP[] = {
+	0.16666666666666635,
+	0.075000000000232006,
+	0.044642857103347776,
+	0.030381947222541554,
+	0.022372055707045795,
+	0.017355063149188971,
+	0.013932318477260263,
+	0.011853657679236356,
+	0.007913855187966402,
+	0.015693588883967092,
+	-0.010162278605856489,
+	0.027738902824743391
+};
+static const int asinDegree = sizeof(asinP) / sizeof(asinP[0]) - 1;
+
+//asin of c in [0, 1]. Above 0.5, asin(c) = pi/2 - 2 asin(sqrt((1 - c) / 2))
+static inline double Asin(double c)
+{
+	bool big = c > 0.5;
+	double s = big ? std::sqrt((1.0 - c) * 0.5) : c;
+	double t = s * s;
+	double p = asinP[asinDegree];
+	for(int k = asinDegree - 1; k >= 0; k--) p = p * t + asinP[k];
+	double a = s + s * t * p;
+	return big ? M_PI_2 - 2.0 * a : a;
+}
+
+GeodesicKernel::GeodesicKernel(const vector<Position> &positions, double speed)
+{
+	const double R = 6371; //km, as in ProblemData::geodesicDistance
+	const double radian = M_PI/180;
+	scale = 2 * R * 1000 / speed;
+
+	x.resize(positions.size());
+	y.resize(positions.size());
+	z.resize(positions.size());
+	for(int i = 0; i < (int) positions.size(); i++)
+	{
+		//position is (longitude, latitude)
+		double lat = radian * positions[i].y;
+		double lon = radian * positions[i].x;
+		x[i] = cos(lat) * cos(lon);
+		y[i] = cos(lat) * sin(lon);
+		z[i] = sin(lat);
+	}
+}
+
+void GeodesicKernel::Row(int i, int first, int last, double* out) const
+{
+	assert(i >= 0 && i < (int) x.size() && first >= 0 && first <= last && last <= (int) x.size());
+	const double* xs = x.data() + first;
+	const double* ys = y.data() + first;
+	const double* zs = z.data() + first;
+	int n = last - first;
+	int k = 0;
+
+#if defined(__SSE2__)
+	const __m128d xi = _mm_set1_pd(x[i]), yi = _mm_set1_pd(y[i]), zi = _mm_set1_pd(z[i]);
+	const __m128d half = _mm_set1_pd(0.5), one = _mm_set1_pd(1.0), two = _mm_set1_pd(2.0), halfPi = _mm_set1_pd(M_PI_2);
+	const __m128d scales = _mm_set1_pd(scale);
+	for(; k + 2 <= n; k += 2)
+	{
+		__m128d dx = _mm_sub_pd(_mm_loadu_pd(xs + k), xi);
+		__m128d dy = _mm_sub_pd(_mm_loadu_pd(ys + k), yi);
+		__m128d dz = _mm_sub_pd(_mm_loadu_pd(zs + k), zi);
+		__m128d chord = _mm_sqrt_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)), _mm_mul_pd(dz, dz)));
+		__m128d c = _mm_min_pd(_mm_mul_pd(chord, half), one);
+
+		//same steps as Asin, both branches computed and then selected
+		__m128d big = _mm_cmpgt_pd(c, half);
+		__m128d s = _mm_or_pd(_mm_and_pd(big, _mm_sqrt_pd(_mm_mul_pd(_mm_sub_pd(one, c), half))), _mm_andnot_pd(big, c));
+		__m128d t = _mm_mul_pd(s, s);
+		__m128d p = _mm_set1_pd(asinP[asinDegree]);
+		for(int d = asinDegree - 1; d >= 0; d--) p = _mm_add_pd(_mm_mul_pd(p, t), _mm_set1_pd(asinP[d]));
+		__m128d a = _mm_add_pd(s, _mm_mul_pd(_mm_mul_pd(s, t), p));
+		a = _mm_or_pd(_mm_and_pd(big, _mm_sub_pd(halfPi, _mm_mul_pd(two, a))), _mm_andnot_pd(big, a));
+
+		_mm_storeu_pd(out + k, _mm_mul_pd(scales, a));
+	}
+#endif
+
+	for(; k < n; k++)
+	{
+		double dx = xs[k] - x[i], dy = ys[k] - y[i], dz = zs[k] - z[i];
+		double c = std::min(std::sqrt(dx * dx + dy * dy + dz * dz) * 0.5, 1.0);
+		out[k] = scale * Asin(c);
+	}
+}
@@ -0,0 +1,113 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+
+#include <boost/filesystem.hpp>
+
+#include "ProblemData.h"
+#include "VInstanceIndex.h"
+
+namespace fs = boost::filesystem;
+
+using std::cout;
+using std::endl;
+using std::string;
+
+/*
+   converts scenarios of Vincent's calls files into compiled instances (see ProblemData::writeCompiledInstance), to be run with
+   --type bin --path <file>. Instance settings that the command line sets anyway (waiting station policy, rerouting...) don't matter here,
+   but the time horizon and the number of vehicles are part of the compiled instance
+
+   usage: InstanceConverter <V|V10> <instance directory> <requests file> <first index> <last index> <output directory> <name prefix> [time horizon (s)] [number of vehicles] [distance cache directory]
+   the instance directory has bases.txt, hospitals.txt and cleaning.txt, as for --type V. Without a time horizon, or with a negative one, there is none.
+   Each scenario index in [first, last] is named <name prefix><instance name> and written to <output directory>/<name>.bin
+
+   usage: InstanceConverter index <instance set directory> <first index> <last index> <output directory> [time horizon (s)] [number of vehicles] [distance cache directory]
+   instances as --instance_index finds them (see FindVInstanceByIndex), named with their file's prefix and written to <output directory>/<instance index>.bin,
+   where --instance_index finds them with --compiled_dir. Without a time horizon, each file's default one is used. With a negative one, there is none
+
+   existing files are never overwritten: the conversion stops at the first one
+*/
+
+static void Usage()
+{
+   cout << "usage: InstanceConverter <V|V10> <instance directory> <requests file> <first index> <last index> <output directory> <name prefix> [time horizon (s)] [number of vehicles] [distance cache directory]" << endl;
+   cout << "       InstanceConverter index <instance set directory> <first index> <last index> <output directory> [time horizon (s)] [number of vehicles] [distance cache directory]" << endl;
+}
+
+int main(int argc, char** argv)
+{
+   string type = argc > 1 ? argv[1] : "";
+   bool byIndex = type == "index";
+   if(type != "V" && type != "V10" && !byIndex)
+   {
+      if(argc > 1) cout << "unsupported instance type " << type << endl;
+      Usage();
+      return 1;
+   }
+   //arguments after the output directory
+   int firstOptional = byIndex ? 6 : 8;
+   if(argc < firstOptional)
+   {
+      Usage();
+      return 1;
+   }
+
+   bool tenColumns = type == "V10";
+   string path = argv[2];
+   string requestsPath = byIndex ? "" : argv[3];
+   int argument = byIndex ? 3 : 4;
+   int firstIndex = std::stoi(argv[argument]);
+   int lastIndex = std::stoi(argv[argument + 1]);
+   fs::path outputDirectory = argv[argument + 2];
+   string prefix = byIndex ? "" : argv[argument + 3];
+   bool hasTimeHorizon = argc > firstOptional;
+   double timeHorizon = hasTimeHorizon ? std::stod(argv[firstOptional]) : -1.0;
+   int nbVehicles = argc > firstOptional + 1 ? std::stoi(argv[firstOptional + 1]) : -1;
+   if(argc > firstOptional + 2) ProblemData::distanceCacheDirectory = argv[firstOptional + 2];
+
+   fs::create_directories(outputDirectory);
+
+   auto start = std::chrono::steady_clock::now();
+   int nbConverted = 0;
+   try
+   {
+      for(int index = firstIndex; index <= lastIndex; index++)
+      {
+         ProblemData problemData;
+         fs::path output;
+         if(byIndex)
+         {
+            string timeHorizonUsage = !hasTimeHorizon ? "default" : timeHorizon >= 0.0 ? "value" : "infinite";
+            FindVInstanceByIndex(path, index, "", problemData, timeHorizonUsage, std::max(timeHorizon, 0.0), nbVehicles);
+            output = outputDirectory / (std::to_string(index) + ".bin");
+         }
+         else
+         {
+            if(!ProblemData::readVincentInstance(requestsPath, path + "/hospitals.txt", path + "/bases.txt", path + "/cleaning.txt", index, problemData, tenColumns, "", timeHorizon >= 0.0, std::max(timeHorizon, 0.0), nbVehicles))
+            {
+               cout << "no scenario " << index << " in " << requestsPath << endl;
+               break;
+            }
+            problemData.name = prefix + problemData.name;
+            output = outputDirectory / (problemData.name + ".bin");
+         }
+
+         if(fs::exists(output))
+         {
+            cout << output.string() << " already exists, not overwriting it" << endl;
+            return 1;
+         }
+         problemData.writeCompiledInstance(output.string());
+         nbConverted++;
+      }
+   }
+   catch(std::exception &e)
+   {
+      cout << e.what() << endl;
+      return 1;
+   }
+
+   cout << "converted " << nbConverted << " instances in " << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << "s" << endl;
+   return 0;
+}
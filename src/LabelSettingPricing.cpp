@@ -0,0 +1,264 @@
+#include "LabelSettingPricing.h"
+#include "RouteExpander.h"
+
+#include <chrono>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+
+LabelSettingPricing::LabelSettingPricing(Params *params, ProblemData* problemData)
+{
+	this->problemData = problemData;
+	this->params = params;
+}
+
+bool LabelSettingPricing::TryAddToBestLabelsHeap(const PricingLabel &label)
+{
+	if(label.reducedCost > -params->RCEpsilon) return false;
+
+	if(bestLabelsHeap.size() < n_desired_routes)
+	{
+		bestLabelsHeap.push_back(label);
+		push_heap(bestLabelsHeap.begin(), bestLabelsHeap.end(), compLRC);
+		return true;
+	}
+	// bestLabelsHeap.front() is the worst label in bestLabelsHeap
+	//if label is better, replace it
+	else if(bestLabelsHeap.front().reducedCost - params->RCEpsilon > label.reducedCost)
+	{
+		pop_heap(bestLabelsHeap.begin(), bestLabelsHeap.end(), compLRC);
+		bestLabelsHeap.pop_back();
+
+		bestLabelsHeap.push_back(label);
+		push_heap(bestLabelsHeap.begin(), bestLabelsHeap.end(), compLRC);
+		return true;
+	}
+
+	return false;
+}
+
+bool LabelSettingPricing::TryAddLabel(const PricingLabel &label)
+{
+	if(params->AllowsPositiveRCElimination(problemData->waitingStationPolicy) && label.reducedCost > -params->RCEpsilon) return false;
+
+	bool best = TryAddToBestLabelsHeap(label);
+
+	//every label already expanded at this request is earlier, so if any of them is better this one is dominated
+	//(it will be checked again when popped, as better labels may be expanded in the meantime)
+	if(!best && label.reducedCost + DominanceEpsilon() > bestExpandedRC[label.reqIndex]) return false;
+
+	PricingLabel* stored = arena.New(label);
+	stored->best = best;
+	queue.push_back(stored);
+	push_heap(queue.begin(), queue.end(), CompLabelOrder());
+
+	pricing_ret.labelsStored++;
+	pricing_ret.maxLabelsStoredSimultaneously = std::max(pricing_ret.maxLabelsStoredSimultaneously, queue.size());
+	return true;
+}
+
+void LabelSettingPricing::Cleanup()
+{
+	queue.clear();
+
+	// best labels heap does NOT have ownership of labels!
+	bestLabelsHeap.clear();
+
+	arena.Reset();
+}
+
+PricingReturn LabelSettingPricing::Price(int vehicle_id, int n_routes, vector<double>& alpha_duals, vector<double>& beta_duals, vector<Route>& outRoutes, vector<int> consideredRequests, const PricingEdges& edges)
+{
+	assert((int) alpha_duals.size() == problemData->NbVehicles());
+	assert((int) beta_duals.size() == problemData->NbRequests());
+	assert(consideredRequests.size() > 0);
+
+	pricing_ret = PricingReturn();
+	pricing_ret.nbConsideredRequests = consideredRequests.size();
+
+	this->n_desired_routes = n_routes;
+	const Vehicle* vehicle = problemData->getVehicle(vehicle_id);
+
+	RouteExpander routeExpander(params);
+	const TransitionTable* transitionTable = problemData->GetTransitionTable(); //may be NULL
+
+	auto alg_start = std::chrono::steady_clock::now();
+	bool timeout = false;
+
+	Cleanup();
+
+	int nbConsidered = consideredRequests.size();
+	bestExpandedRC.assign(nbConsidered, HUGE_VAL);
+	nbExpanded.assign(nbConsidered, 0);
+
+	vector<const Request*> requests(nbConsidered);
+	vector<int> requestIndices(nbConsidered);
+	for (int i = 0; i < nbConsidered; i++)
+	{
+		requests[i] = problemData->GetRequest(consideredRequests[i]);
+		requestIndices[i] = problemData->RequestIdToIndex(consideredRequests[i]);
+	}
+
+	//initial labels, leaving the vehicle's initial position
+	for (int i = 0; i < nbConsidered; i++)
+	{
+		const Request* nextReq = requests[i];
+
+		double newTime;
+		int waitingStation;
+		bool useIntermediate;
+		IntermediateVertex intermediateVertex;
+		bool ret = routeExpander.checkRouteExpansion(problemData, vehicle_id, nextReq, problemData->GetInitialPosition(vehicle_id), vehicle->timeAvailable, newTime, waitingStation, useIntermediate, intermediateVertex);
+		pricing_ret.labelsPriced++;
+
+		if (!ret || newTime > problemData->timeHorizon) continue;
+
+		double lateness = problemData->weighted_lateness(nextReq, newTime);
+
+		PricingLabel label;
+		label.reqIndex = i;
+		label.reducedCost = lateness - alpha_duals[vehicle_id] - beta_duals[requestIndices[i]];
+		label.time = newTime;
+		label.lastWaitingStation = useIntermediate ? -1 : waitingStation;
+		label.intermediatePosition = useIntermediate ? arena.New(intermediateVertex) : NULL;
+		label.lastLabel = NULL;
+		label.best = false;
+
+		TryAddLabel(label);
+	}
+
+	//label setting, in increasing time order
+	while(!queue.empty() && !timeout)
+	{
+		pop_heap(queue.begin(), queue.end(), CompLabelOrder());
+		const PricingLabel* label = queue.back();
+		queue.pop_back();
+
+		int i = label->reqIndex;
+		const Request* req = requests[i];
+
+		//a better label may have been expanded since this one was queued
+		if(!label->best && label->reducedCost + DominanceEpsilon() > bestExpandedRC[i])
+		{
+			pricing_ret.labelsDeleted++;
+			continue;
+		}
+		bestExpandedRC[i] = std::min(bestExpandedRC[i], label->reducedCost);
+		nbExpanded[i]++;
+
+		for(int j = 0; j < nbConsidered && !timeout; j++)
+		{
+			if(i == j) continue;
+			const Request* nextReq = requests[j];
+
+			int iNextReq = requestIndices[j];
+
+			//if branching rule forbids this request-to-request connection, skip it
+			if(edges.IsForbidden(requestIndices[i], iNextReq)) continue;
+
+			double newTime = 0.0;
+			int waitingStation = -1;
+			bool useIntermediate = false;
+			IntermediateVertex intermediateVertex = IntermediateVertex();
+			bool ret = routeExpander.checkRequestExpansion(problemData, transitionTable, vehicle_id, nextReq, iNextReq, req, requestIndices[i], label->time, newTime, waitingStation, useIntermediate, intermediateVertex);
+			pricing_ret.labelsPriced++;
+
+			//if the arena exceeds 95% of max_memory,
+			if(((double)arena.BytesUsed() / 1000000) > (double) max_memory * 0.95)
+			{
+				std::cout << "memory out (" << pricing_ret.labelsStored << " labels, " << arena.BytesUsed() / 1000000 << " MB)" << std::endl;
+				timeout = true;
+				break;
+			}
+
+			if(pricing_ret.labelsPriced % 1000 == 0)
+			{
+				double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - alg_start).count();
+				if(time > max_time || params->Timeout())
+				{
+					timeout = true;
+					break;
+				}
+			}
+
+			if (!ret) continue;
+
+			double lateness = problemData->weighted_lateness(nextReq, newTime);
+			assert(lateness > params->RCEpsilon);
+
+			double newReducedCost = label->reducedCost + lateness - beta_duals[iNextReq];
+
+			//add edge duals:
+			newReducedCost = newReducedCost - edges.Dual(requestIndices[i], iNextReq);
+
+			PricingLabel newLabel;
+			newLabel.reqIndex = j;
+			newLabel.reducedCost = newReducedCost;
+			newLabel.time = newTime;
+			newLabel.lastWaitingStation = useIntermediate ? -1 : waitingStation;
+			newLabel.intermediatePosition = useIntermediate ? arena.New(intermediateVertex) : NULL;
+			newLabel.lastLabel = label;
+			newLabel.best = false;
+
+			TryAddLabel(newLabel);
+		}
+	}
+
+	pricing_ret.mostLabelsInRequest = nbExpanded.empty() ? 0 : *std::max_element(nbExpanded.begin(), nbExpanded.end());
+	pricing_ret.timeout = timeout;
+
+	if(bestLabelsHeap.size() == 0)
+	{
+		//no routes found with RC < 0
+		Cleanup();
+		pricing_ret.status = PricingReturnStatus::FAIL;
+		return pricing_ret;
+	}
+
+	outRoutes.clear();
+
+	for (int r = 0; r < (int) bestLabelsHeap.size(); r++)
+	{
+		Route route;
+		const PricingLabel* label = &bestLabelsHeap[r];
+		double firstLabelRC = label->reducedCost;
+
+		//first, add it all in reverse:
+		while (label != NULL)
+		{
+			route.vertices.push_back(*requests[label->reqIndex]);
+
+			assert(!(label->intermediatePosition != NULL && label->lastWaitingStation != -1));
+
+			if(label->intermediatePosition != NULL)
+			{
+				assert(label->intermediatePosition->id == -1);
+				route.intermediates.push_back(*label->intermediatePosition);
+				route.vertices.push_back((Vertex) *label->intermediatePosition);
+			}
+			if (label->lastWaitingStation != -1) { //if this transition stops at a waiting station...
+				const WaitingStation* ws = problemData->GetWaitingStation(label->lastWaitingStation);
+				route.vertices.push_back(*ws); //add waiting station
+			}
+
+			label = label->lastLabel;
+		}
+
+		//insert source vertex
+		route.vertices.push_back(*problemData->GetInitialPosition(vehicle_id));
+		route.veh_index = vehicle_id;
+
+		//reverse entire route
+		std::reverse(route.vertices.begin(), route.vertices.end());
+		std::reverse(route.intermediates.begin(), route.intermediates.end());
+
+		route.SetArrivalsAndDepartures(problemData);
+		route.UpdateCost(problemData);
+		outRoutes.push_back(route);
+		pricing_ret.reducedCostPerRoute.push_back(firstLabelRC);
+	}
+
+	Cleanup();
+	pricing_ret.status = PricingReturnStatus::OK;
+	return pricing_ret;
+}
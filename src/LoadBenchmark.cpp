@@ -0,0 +1,242 @@
+#include <iostream>
+#include <fstream>
+#include <random>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+
+#include <boost/filesystem.hpp>
+
+#include "ProblemData.h"
+#include "StaticInfrastructure.h"
+#include "CallFile.h"
+#include "DistanceCache.h"
+
+namespace fs = boost::filesystem;
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+/*
+   times ProblemData::readVincentInstance on synthetic scenarios of 40, 200 and 600 calls.
+   The files are written to a temporary directory in the 13 columns format, with bases, hospitals and cleaning bases spread over Montreal
+
+   usage: LoadBenchmark [repetitions] [distance cache directory]
+   prints the best time of the repetitions for each scenario. With a cache, the first load also fills it (see DistanceCache)
+
+   usage: LoadBenchmark check <instance directory>
+   reads every scenario of <instance directory>/calls.txt, in the 13 columns format, with bases.txt, hospitals.txt and cleaning.txt as for --type V.
+   Fails unless each stored distance matches its direct calculation, and a distance cache hit gives the same matrix as the miss that stored it
+*/
+
+static void WritePositions(std::ofstream &out, std::mt19937 &gen, int nbPositions)
+{
+   std::uniform_real_distribution<double> lat(45.40, 45.70), lon(-73.95, -73.45);
+   for(int i = 0; i < nbPositions; i++)
+   {
+      double y = lat(gen);
+      out << y << " " << lon(gen) << "\n";
+   }
+   out << "END\n";
+}
+
+//GeodesicKernel's tolerance against ProblemData::geodesicDistance
+static bool SameDistance(double distance, double expected)
+{
+   return std::abs(distance - expected) <= 1e-12 * expected + 1e-9;
+}
+
+//compares every stored distance of the scenario to its calculation from the positions, as readVincentInstance did pair by pair
+static bool CheckDistances(const ProblemData &problemData, const StaticInfrastructure &infrastructure, const vector<Call> &calls)
+{
+   const DistanceMatrix &distances = problemData.Distances();
+   int nbErrors = 0;
+   for(int i = 0; i < problemData.NbVertices(); i++)
+   {
+      for(int j = 0; j < problemData.NbVertices(); j++)
+      {
+         if(!distances.IsStored(i, j)) continue;
+
+         double expected;
+         if(i == j) expected = 0.0;
+         else if(problemData.IsRequest(i) && j == problemData.GetRequest(i)->destination)
+         {
+            //through the hospital, then the cleaning base if needed
+            const Call &call = calls[problemData.RequestIdToIndex(i)];
+            const Position &hospital = infrastructure.Hospitals()[(int) call.indexHospital];
+            expected = ProblemData::calculateDistance(problemData.GetVertex(i)->position, hospital, DistanceType::geodesic);
+            if(call.cleaningNeeded) expected += ProblemData::calculateDistance(hospital, infrastructure.CleaningBases()[(int) call.indexCleaning], DistanceType::geodesic);
+         }
+         else expected = ProblemData::calculateDistance(problemData.GetVertex(i)->position, problemData.GetVertex(j)->position, DistanceType::geodesic);
+
+         if(!SameDistance(distances(i, j), expected) && nbErrors++ < 10)
+         {
+            cout << problemData.name << ": distance " << i << " -> " << j << " is " << distances(i, j) << ", expected " << expected << endl;
+         }
+      }
+   }
+   return nbErrors == 0;
+}
+
+//stores the matrix for inputs in an empty cache directory, then loads it back
+static bool CheckDistanceCache(const DistanceMatrix &distances, const string &directory, const string &inputs)
+{
+   DistanceCache cache(directory);
+   int nbBuilds = 0;
+   auto build = [&]()
+   {
+      nbBuilds++;
+      return distances;
+   };
+   DistanceMatrix miss = cache.GetOrBuild(inputs, distances.NbVehicles(), distances.NbRequests(), distances.NbWaitingStations(), build);
+   DistanceMatrix hit = cache.GetOrBuild(inputs, distances.NbVehicles(), distances.NbRequests(), distances.NbWaitingStations(), build);
+   if(nbBuilds != 1)
+   {
+      cout << "distance cache: " << nbBuilds << " builds for the same inputs" << endl;
+      return false;
+   }
+
+   for(const DistanceMatrix* matrix : {&miss, &hit})
+   {
+      if(matrix->MemoryUsage() != distances.MemoryUsage() || memcmp(matrix->Data(), distances.Data(), distances.MemoryUsage()) != 0)
+      {
+         cout << "distance cache: " << (matrix == &miss ? "miss" : "hit") << " differs from the built matrix" << endl;
+         return false;
+      }
+   }
+
+   for(fs::directory_iterator file(directory); file != fs::directory_iterator(); file++)
+   {
+      if(file->path().extension() == ".lock")
+      {
+         cout << "distance cache: " << file->path() << " left after storing" << endl;
+         return false;
+      }
+   }
+
+   //a file stored for other inputs under the same key, as a hash collision would, is a miss
+   auto fileOf = [&](const string &fileInputs)
+   {
+      char name[32];
+      snprintf(name, sizeof(name), "%016llx.dist", (unsigned long long) DistanceCache::Hash(fileInputs.data(), fileInputs.size()));
+      return fs::path(directory) / name;
+   };
+   string otherInputs = inputs + " collision";
+   fs::remove(fileOf(otherInputs));
+   fs::copy_file(fileOf(inputs), fileOf(otherInputs));
+   cache.GetOrBuild(otherInputs, distances.NbVehicles(), distances.NbRequests(), distances.NbWaitingStations(), build);
+   if(nbBuilds != 2)
+   {
+      cout << "distance cache: hit on a file stored for other inputs" << endl;
+      return false;
+   }
+   return true;
+}
+
+static int Check(const string &path)
+{
+   string callsPath = path + "/calls.txt";
+   std::shared_ptr<const StaticInfrastructure> infrastructure = StaticInfrastructure::Get(path + "/bases.txt", path + "/hospitals.txt", path + "/cleaning.txt", DistanceType::geodesic);
+   std::shared_ptr<const CallFile> callFile = CallFile::Open(callsPath);
+   if(callFile->NbScenarios() == 0)
+   {
+      cout << "no scenario in " << callsPath << endl;
+      return 1;
+   }
+
+   fs::path cacheDirectory = fs::temp_directory_path() / fs::unique_path("vincent-check-%%%%-%%%%");
+   bool ok = true;
+   for(int index = 0; index < callFile->NbScenarios(); index++)
+   {
+      ProblemData problemData;
+      ProblemData::readVincentInstance(callsPath, path + "/hospitals.txt", path + "/bases.txt", path + "/cleaning.txt", index, problemData, false, "");
+      ok = CheckDistances(problemData, *infrastructure, callFile->Scenario(index, false)) && ok;
+      ok = CheckDistanceCache(problemData.Distances(), cacheDirectory.string(), problemData.name) && ok;
+   }
+   fs::remove_all(cacheDirectory);
+
+   cout << (ok ? "distances match in " : "distances differ in ") << callFile->NbScenarios() << " scenarios" << endl;
+   return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv)
+{
+   if(argc > 1 && string(argv[1]) == "check")
+   {
+      if(argc < 3)
+      {
+         cout << "usage: LoadBenchmark check <instance directory>" << endl;
+         return 1;
+      }
+      return Check(argv[2]);
+   }
+
+   int repetitions = argc > 1 ? std::stoi(argv[1]) : 5;
+   if(argc > 2) ProblemData::distanceCacheDirectory = argv[2];
+   const int nbBases = 40, nbHospitals = 20, nbCleaningBases = 5;
+   const vector<int> scenarioSizes = {40, 200, 600};
+
+   fs::path dir = fs::temp_directory_path() / fs::unique_path("vincent-load-%%%%-%%%%");
+   fs::create_directories(dir);
+   string basesPath = (dir / "bases.txt").string();
+   string hospitalsPath = (dir / "hospitals.txt").string();
+   string cleaningPath = (dir / "cleaning.txt").string();
+   string callsPath = (dir / "calls.txt").string();
+
+   std::mt19937 gen(0);
+   {
+      std::ofstream bases(basesPath);
+      WritePositions(bases, gen, nbBases);
+      std::ofstream hospitals(hospitalsPath);
+      WritePositions(hospitals, gen, nbHospitals);
+      std::ofstream cleaning(cleaningPath);
+      cleaning << nbCleaningBases << "\n";
+      WritePositions(cleaning, gen, nbCleaningBases);
+   }
+   {
+      std::ofstream calls(callsPath);
+      calls.precision(10);
+      std::uniform_real_distribution<double> U(0, 1), lat(45.40, 45.70), lon(-73.95, -73.45);
+      for(int nbCalls : scenarioSizes)
+      {
+         calls << nbCalls << "\n";
+         for(int i = 0; i < nbCalls; i++)
+         {
+            //Time - Region index - Priority - Day - Time on scene - Lat - Long - Time at hospital - TimeCleaningBase - Cleaning needed - Hospital needed - index hospital - index_cleaning
+            bool cleaning = U(gen) < 0.1;
+            double time = 8.0 + 12.0 * U(gen);
+            int priority = (int) (3 * U(gen));
+            double timeOnScene = 0.1 + 0.3 * U(gen);
+            double y = lat(gen), x = lon(gen);
+            double timeAtHospital = 0.2 + 0.5 * U(gen);
+            int hospital = (int) (nbHospitals * U(gen));
+            int cleaningBase = (int) (nbCleaningBases * U(gen));
+            calls << time << " 0 " << priority << " 1 " << timeOnScene << " " << y << " " << x << " " << timeAtHospital << " " << (cleaning ? 0.5 : 0.0) << " "
+               << cleaning << " 1 " << hospital << " " << cleaningBase << "\n";
+         }
+      }
+   }
+
+   cout << "calls\tvertices\tdistances (MB)\tbest load time of " << repetitions << " (ms)" << endl;
+   for(int s = 0; s < (int) scenarioSizes.size(); s++)
+   {
+      ProblemData problemData;
+      double best = HUGE_VAL;
+      for(int r = 0; r < repetitions; r++)
+      {
+         auto start = std::chrono::steady_clock::now();
+         ProblemData::readVincentInstance(callsPath, hospitalsPath, basesPath, cleaningPath, s, problemData, false, "");
+         best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+      }
+      cout << scenarioSizes[s] << "\t" << problemData.NbVertices() << "\t" << problemData.Distances().MemoryUsage() / (1024.0 * 1024.0) << "\t" << best << endl;
+   }
+
+   fs::remove_all(dir);
+   return 0;
+}
@@ -0,0 +1,47 @@
+#include "NgNeighbourhoods.h"
+
+#include <algorithm>
+#include <numeric>
+
+std::shared_ptr<const NgNeighbourhoods> NgNeighbourhoods::Build(ProblemData *problemData, int size)
+{
+	int n = problemData->NbRequests();
+	size = std::clamp(size, 1, std::min(MaxSize, std::max(n, 1)));
+
+	//constructor is private
+	std::shared_ptr<NgNeighbourhoods> ng(new NgNeighbourhoods());
+	ng->nbRequests = n;
+	ng->size = size;
+	ng->neighbours.assign((size_t) n * size, -1);
+	ng->position.assign((size_t) n * n, -1);
+
+	vector<int> others;
+	vector<double> distance(n);
+	for(int i = 0; i < n; i++)
+	{
+		const Request* req = problemData->GetRequestByIndex(i);
+		for(int k = 0; k < n; k++)
+		{
+			distance[k] = problemData->Distance(req->destination, problemData->IndexToRequestId(k));
+		}
+
+		others.resize(n);
+		std::iota(others.begin(), others.end(), 0);
+		others.erase(others.begin() + i);
+		std::partial_sort(others.begin(), others.begin() + (size - 1), others.end(), [&distance](int a, int b)
+		{
+			return distance[a] < distance[b] || (distance[a] == distance[b] && a < b);
+		});
+
+		int* row = &ng->neighbours[(size_t) i * size];
+		row[0] = i;
+		std::copy(others.begin(), others.begin() + (size - 1), row + 1);
+
+		for(int p = 0; p < size; p++)
+		{
+			ng->position[(size_t) i * n + row[p]] = p;
+		}
+	}
+
+	return ng;
+}
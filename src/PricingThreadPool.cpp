@@ -0,0 +1,88 @@
+#include "PricingThreadPool.h"
+
+#include <assert.h>
+
+PricingThreadPool::PricingThreadPool(int nbThreads) : task(NULL), nbTasks(0), nextTask(0), nbFinishedTasks(0), batchCounter(0), stopping(false)
+{
+	assert(nbThreads > 0);
+
+	workers.reserve(nbThreads);
+	for(int i = 0; i < nbThreads; i++)
+	{
+		workers.emplace_back(&PricingThreadPool::WorkerLoop, this, i);
+	}
+}
+
+PricingThreadPool::~PricingThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	workAvailable.notify_all();
+
+	for(std::thread &worker : workers)
+	{
+		worker.join();
+	}
+}
+
+void PricingThreadPool::WorkerLoop(int worker)
+{
+	size_t lastBatch = 0;
+
+	std::unique_lock<std::mutex> lock(mutex);
+	while(true)
+	{
+		workAvailable.wait(lock, [&]{ return stopping || batchCounter != lastBatch; });
+		if(stopping) return;
+		lastBatch = batchCounter;
+
+		//grab tasks from the current batch until there are none left
+		while(nextTask < nbTasks)
+		{
+			int i = nextTask++;
+			const std::function<void(int, int)>* current = task;
+
+			lock.unlock();
+			std::exception_ptr taskError;
+			try
+			{
+				(*current)(worker, i);
+			}
+			catch(...)
+			{
+				taskError = std::current_exception();
+			}
+			lock.lock();
+
+			if(taskError && !error) error = taskError;
+
+			nbFinishedTasks++;
+			if(nbFinishedTasks == nbTasks) workDone.notify_all();
+		}
+	}
+}
+
+void PricingThreadPool::Run(int nbTasks, const std::function<void(int worker, int task)> &task)
+{
+	if(nbTasks <= 0) return;
+
+	std::unique_lock<std::mutex> lock(mutex);
+	this->task = &task;
+	this->nbTasks = nbTasks;
+	nextTask = 0;
+	nbFinishedTasks = 0;
+	error = NULL;
+	batchCounter++;
+
+	workAvailable.notify_all();
+	workDone.wait(lock, [&]{ return nbFinishedTasks == this->nbTasks; });
+
+	this->task = NULL;
+	std::exception_ptr batchError = error;
+	error = NULL;
+	lock.unlock();
+
+	if(batchError) std::rethrow_exception(batchError);
+}
@@ -6,11 +6,25 @@
 #include <algorithm>  
 #include <chrono>
 #include <random>
+#include <thread>
 //#include <float.h>
 #include <limits.h>
+#include <cstring>
+#include <type_traits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "ProblemData.h"
+#include "RouteExpander.h"
+#include "NgNeighbourhoods.h"
 #include "OSRMHelper.h"
+#include "GeodesicKernel.h"
+#include "StaticInfrastructure.h"
+#include "CallFile.h"
+#include "DistanceCache.h"
+#include "PricingThreadPool.h"
 
 using std::unique_ptr;
 using std::make_unique;
@@ -22,6 +36,7 @@ using std::move;
 ProblemData::ProblemData()
 {
 	this->exampleInstance();
+	this->ComputeVehicleClasses();
 #ifdef _DEBUG
 	this->Validate();
 #endif
@@ -40,6 +55,7 @@ ProblemData::ProblemData(string pathToInstance, string instance_type)
 	else if (instance_type == "pdptw") readPDPTWInstance(pathToInstance);
 	else if (instance_type == "sdvrptw") readSDVRPTWInstance(pathToInstance);
 	else throw std::invalid_argument("unsuported instance type");
+	this->ComputeVehicleClasses();
 #ifdef _DEBUG
 	this->Validate();
 #endif
@@ -56,6 +72,8 @@ void ProblemData::Validate()
 	for (int ii = 0; ii < requests.size(); ii++)
 	{
 		assert(requests[ii].id == i);
+		//the distance matrix only stores the distance from a request to this destination
+		assert(requests[ii].destination == requests[ii].id + NbRequests());
 		i++;
 	}
 	for (int ii = 0; ii < requests.size(); ii++)
@@ -73,12 +91,7 @@ void ProblemData::Validate()
 		assert(IsWaitingStation(vehicles[iVeh].preferredWaitingStation));
 	}
 
-	int nbVertices = NbVertices();
-	assert(nbVertices == distances.size());
-	for(int i = 0; i < distances.size(); i++)
-	{
-		assert(distances[i].size() == nbVertices);
-	}
+	assert(distances.NbVertices() == NbVertices());
 }
 
 void ProblemData::SetVehicleAvailability(vector<double> vehicleAvailability)
@@ -90,6 +103,8 @@ void ProblemData::SetVehicleAvailability(vector<double> vehicleAvailability)
 		if(vehicleAvailability[0] < 0.0) throw std::invalid_argument("negative value not allowed");
 		vehicles[i].timeAvailable = vehicleAvailability[i];
 	}
+
+	ComputeVehicleClasses();
 }
 
 void ProblemData::exampleInstance()
@@ -150,8 +165,7 @@ void ProblemData::exampleInstance()
 	for (int i = 0; i < waitingStations.size(); i++) vertices[NbVehicles() + 2*nbRequests + i] = &waitingStations[i];
 
 	distanceType = DistanceType::euclidian;
-	distances = vector<vector<double>>();
-	CalculateDistanceMatrix(vertices, distances, DistanceType::euclidian);
+	CalculateDistances(vertices);
 	
 	for (int i = 0; i < vertices.size(); i++)
 	{
@@ -301,8 +315,7 @@ void ProblemData::readPDPTWInstance(string path)
 #endif // DEBUG
 
 	distanceType = DistanceType::euclidian;
-	distances = vector<vector<double>>();
-	CalculateDistanceMatrix(vertices, distances, DistanceType::euclidian);
+	CalculateDistances(vertices);
 
 	for (int i = 0; i < vertices.size(); i++)
 	{
@@ -318,20 +331,84 @@ void ProblemData::readPDPTWInstance(string path)
 
 }
 
-void ProblemData::CalculateDistanceMatrix(vector<Vertex*> &vertices, vector<vector<double>> &outMatrix, DistanceType distanceType)
+string ProblemData::distanceCacheDirectory = "";
+DistancePrecision ProblemData::distancePrecision = DistancePrecision::float64;
+
+//part of the distance cache inputs: bump whenever the distances calculated from the same positions change (e.g. GeodesicKernel's arithmetic)
+static const uint32_t distanceCalculationVersion = 1;
+
+void ProblemData::CalculateDistances(vector<Vertex*> &vertices, const vector<double>* requestToDestination, const vector<int>* infrastructureSites)
 {
-	//to-do: osrm
-	outMatrix = vector<vector<double>>();
-	outMatrix.reserve(vertices.size());
-	for (int i = 0; i < vertices.size(); i++)
+	assert((int) vertices.size() == NbVertices());
+	assert(requestToDestination == NULL || (int) requestToDestination->size() == NbRequests());
+	assert(infrastructureSites == NULL || (infrastructure && (int) infrastructureSites->size() == NbVertices() && NbWaitingStations() <= infrastructure->NbBases()));
+
+	auto build = [&](DistancePrecision precision)
 	{
-		outMatrix.push_back(vector<double>(vertices.size()));
-		for (int j = 0; j < vertices.size(); j++)
+		std::unique_ptr<GeodesicKernel> kernel;
+		if(distanceType == DistanceType::geodesic)
 		{
-			if (i == j) outMatrix[i][j] = 0.0;
-			else outMatrix[i][j] = calculateDistance(vertices[i]->position, vertices[j]->position, distanceType);
+			vector<Position> positions(vertices.size());
+			for(int i = 0; i < (int) vertices.size(); i++) positions[i] = vertices[i]->position;
+			kernel = std::make_unique<GeodesicKernel>(positions, VehicleSpeed());
 		}
+
+		//threads only pay off for large matrices
+		int nbThreads = std::min<int>(std::thread::hardware_concurrency(), NbVertices() / 500);
+		std::unique_ptr<PricingThreadPool> pool;
+		if(nbThreads > 1) pool = std::make_unique<PricingThreadPool>(nbThreads);
+
+		return DistanceMatrix::Build(NbVehicles(), NbRequests(), NbWaitingStations(), [&](int i, int first, int last, double* out)
+		{
+			if(requestToDestination != NULL && IsRequest(i) && first == i + NbRequests())
+			{
+				*out = (*requestToDestination)[RequestIdToIndex(i)];
+			}
+			else if(infrastructureSites != NULL && (*infrastructureSites)[i] != -1 && first == NbVehicles() + 2 * NbRequests())
+			{
+				//waiting station k is base k
+				const double* toBases = infrastructure->ToBases((*infrastructureSites)[i]);
+				std::copy(toBases, toBases + (last - first), out);
+			}
+			else if(kernel)
+			{
+				kernel->Row(i, first, last, out);
+			}
+			else
+			{
+				for(int j = first; j < last; j++) out[j - first] = i == j ? 0.0 : calculateDistance(vertices[i]->position, vertices[j]->position);
+			}
+		}, pool.get(), precision);
+	};
+
+	//small matrices are faster to calculate than to load
+	if(distanceCacheDirectory.empty() || NbVertices() < 100)
+	{
+		distances = build(distancePrecision);
+		return;
+	}
+
+	//everything the distances depend on, including how they are calculated
+	string inputs;
+	auto append = [&](const void* data, size_t bytes) { inputs.append(static_cast<const char*>(data), bytes); };
+	int counts[3] = {NbVehicles(), NbRequests(), NbWaitingStations()};
+	double speed = VehicleSpeed();
+	bool overridden = requestToDestination != NULL;
+	append(&distanceCalculationVersion, sizeof(distanceCalculationVersion));
+	append(&distanceType, sizeof(distanceType));
+	append(counts, sizeof(counts));
+	append(&speed, sizeof(speed));
+	for(const Vertex* vertex : vertices)
+	{
+		double position[2] = {vertex->position.x, vertex->position.y};
+		append(position, sizeof(position));
 	}
+	append(&overridden, sizeof(overridden));
+	if(overridden) append(requestToDestination->data(), requestToDestination->size() * sizeof(double));
+
+	//the cache holds float64 matrices, converted from the mapping
+	distances = DistanceCache(distanceCacheDirectory).GetOrBuild(inputs, NbVehicles(), NbRequests(), NbWaitingStations(), [&]() { return build(DistancePrecision::float64); });
+	distances = distances.WithPrecision(distancePrecision);
 }
 
 /*/
@@ -446,8 +523,7 @@ void ProblemData::readSDVRPTWInstance(string path)
 #endif // DEBUG
 
 	distanceType = DistanceType::euclidian;
-	distances = vector<vector<double>>();
-	CalculateDistanceMatrix(vertices, distances, DistanceType::euclidian);
+	CalculateDistances(vertices);
 
 	for (int i = 0; i < vertices.size(); i++)
 	{
@@ -470,58 +546,43 @@ bool ProblemData::readVincentInstance(string requests_path, string hospitals_pat
 	bool useOSM = false;
 	if(osmPath != "") useOSM = true;
 
+	//files 1, 2 and aux: bases.txt, hospitals.txt and the cleaning bases file, shared by every instance read from them
+	std::shared_ptr<const StaticInfrastructure> infrastructure = StaticInfrastructure::Get(waiting_stations_path, hospitals_path, cleaning_stations_path, useOSM ? DistanceType::osrm : DistanceType::geodesic);
+
 	vector<InitialPosition> initialPositions;
 	vector<WaitingStation> waitingStations;
 	vector<Vehicle> vehicles;
+	vector<int> initialPositionBases; //base index of each initial position
 
-	vector<Position> hospitalPositions;
-	
-	//file 1: bases.txt
+	//bases
 	/* 
 		assume each base only has one ambulance in it and capacity for one ambulance
 		also assume that this ambulance has the base as its home base
 	*/
 	{
-		std::ifstream infile(waiting_stations_path);
-		std::string line;
-
 		bool useOverwriteNbVehicles = overwriteNbVehicles > 0;
-		
-		if (!infile.good()) throw std::invalid_argument("file " + waiting_stations_path + " not found");
-
-		double posx, posy;
+		int nbBases = infrastructure->NbBases();
+		if(useOverwriteNbVehicles) nbBases = std::min(nbBases, overwriteNbVehicles);
 
 		int veh_type = 0;
 
-		while (std::getline(infile, line))
+		for(int i = 0; i < nbBases; i++)
 		{
-			if(line == "END") break;
-
-			if(useOverwriteNbVehicles && vehicles.size() >= overwriteNbVehicles) break;
-
-			std::istringstream iss(line);
-			//(lat, long) order -> (posy, posx)
-			if (!(iss >> posy >> posx)) {
-				throw std::invalid_argument("unexpected file format");
-			}
-
-			Position pos; pos.x = posx; pos.y = posy;
+			Position pos = infrastructure->Bases()[i];
 			InitialPosition ipos; ipos.id = initialPositions.size(); ipos.identifier = initialPositions.size();
 			ipos.position = pos;
 			initialPositions.push_back(ipos);
+			initialPositionBases.push_back(i);
 
 			WaitingStation ws; ws.id = -1;
 			ws.position = pos;
-			//positions[i] = pos;
 			waitingStations.push_back(ws);
 
-
 			//alterna tipos de veiculo, do 0 ate 2
 			Vehicle veh; veh.type = veh_type; veh.timeAvailable = 0.0;
 			veh_type = (veh_type + 1) % 3;
 			veh.preferredWaitingStation = -1;
 			vehicles.push_back(veh);
-
 		}
 
 		if(useOverwriteNbVehicles)
@@ -532,10 +593,10 @@ bool ProblemData::readVincentInstance(string requests_path, string hospitals_pat
 			{
 				//create copy from original veh
 				int origVeh = i % origNb;
-				Position pos; pos.x = initialPositions[origVeh].position.x; pos.y = initialPositions[origVeh].position.y;
 				InitialPosition ipos; ipos.id = initialPositions.size(); ipos.identifier = initialPositions.size();
-				ipos.position = pos;
+				ipos.position = initialPositions[origVeh].position;
 				initialPositions.push_back(ipos);
+				initialPositionBases.push_back(origVeh);
 
 				//alterna tipos de veiculo, do 0 ate 2
 				Vehicle veh; veh.type = veh_type; veh.timeAvailable = 0.0;
@@ -548,115 +609,31 @@ bool ProblemData::readVincentInstance(string requests_path, string hospitals_pat
 
 	}
 
-	//file 2: hospitals.txt
-	/* 
-		read hospitals locations, later to be used as destinations
-	*/
-	{
-		std::ifstream infile(hospitals_path);
-		std::string line;
-
-		if (!infile.good()) throw std::invalid_argument("file " + hospitals_path + " not found");
-		double posx, posy;
-
-		while (std::getline(infile, line))
-		{
-			if(line == "END") break;
-			std::istringstream iss(line);
-			//(lat, long) order -> (posy, posx)
-			if (!(iss >> posy >> posx)) {
-				throw std::invalid_argument("unexpected file format");
-			}
-
-			Position pos; pos.x = posx; pos.y = posy;
-			hospitalPositions.push_back(pos);
-		}
-
-	}
-
-	vector<Position> cleaningBases;
+	const vector<Position> &hospitalPositions = infrastructure->Hospitals();
+	vector<int> reqToHospitalIndex;
 	vector<int> reqToCleaningBaseIndex;
 
-	//aux file: cleaning bases file
-	/* 
-		read cleaning base locations, later to be used as destinations
-	*/
-	{
-		std::ifstream infile(cleaning_stations_path);
-		std::string line;
-
-		if (!infile.good()) throw std::invalid_argument("file " + cleaning_stations_path + " not found");
-		double posx, posy;
-
-		//first line is nb of stations:
-		std::getline(infile, line);
-		int nbCleaning;
-		std::istringstream iss(line);
-		if (!(iss >> nbCleaning)) {
-			throw std::invalid_argument("unexpected file format: " + cleaning_stations_path);
-		}
-
-		while (std::getline(infile, line))
-		{
-			if(line == "END") break;
-			std::istringstream iss(line);
-			//(lat, long) order -> (posy, posx)
-			if (!(iss >> posy >> posx)) {
-				break;
-				//throw std::invalid_argument("unexpected file format");
-			}
-
-			Position pos; pos.x = posx; pos.y = posy;
-			cleaningBases.push_back(pos);
-		}
-
-		if(nbCleaning != cleaningBases.size())
-			throw std::invalid_argument("unexpected file format: " + cleaning_stations_path);
-
-	}
-
 	//file 3: calls file
 	/* 
-		file has several scenarios/instance. Iterate until found the one with the correct index
+		file has several scenarios/instance. Only the one with the correct index is read, see CallFile
 	*/
-    std::mt19937 gen(0);
 	{
-		std::ifstream infile(requests_path);
-		std::string line;
-		if (!infile.good()) throw std::invalid_argument("file not found : " + requests_path);
-
-		double time, time_on_scene, lat, lon, time_at_hospital, time_cleaning_base;
-		double region_index, priority, day, cleaning_needed, hospital_needed, index_hospital, index_cleaning; //(int, but double for correct parsing)
+		std::shared_ptr<const CallFile> callFile = CallFile::Open(requests_path);
 
-		int nbRequests;
-		
-		int instance_i = 0;
-		//move to correct instance_index
-		while(instance_i < instance_index && std::getline(infile, line))
+		if(instance_index >= callFile->NbScenarios())
 		{
-			std::istringstream iss(line);
-			if (!(iss >> nbRequests)) {
-				throw std::invalid_argument("unexpected file format:" + requests_path);
-			}
-
-			for(int i = 0; i < nbRequests; i++)
-			{
-				if(!std::getline(infile, line) ) throw std::invalid_argument("unexpected file format" + requests_path);
-			}
-
-			instance_i++;
+			if(!callFile->IsComplete()) throw std::invalid_argument("unexpected file format:" + requests_path);
+			if(instance_index > callFile->NbScenarios()) throw std::invalid_argument(std::to_string(instance_index) + " exceeds number of instances in file " + requests_path);
+			return false;
 		}
 
-		if(instance_i != instance_index) throw std::invalid_argument(std::to_string(instance_index) + " exceeds number of instances in file " + requests_path);
-
-		while(std::getline(infile, line))
-		{	
-			std::istringstream iss(line);
-			if (!(iss >> nbRequests)) {
-					throw std::invalid_argument("unexpected file format");
-			}
+		//the scenario
+		{
+			vector<Call> calls = callFile->Scenario(instance_index, tenColumns);
+			int nbRequests = calls.size();
 
 			outInstance = ProblemData();
+			outInstance.infrastructure = infrastructure;
 			outInstance.name = "V-" + std::to_string(instance_index) + "-" + std::to_string(nbRequests);
 
 			if(useTimeHorizon)
@@ -668,9 +645,10 @@ bool ProblemData::readVincentInstance(string requests_path, string hospitals_pat
 				outInstance.timeHorizon = std::numeric_limits<double>::infinity();
 			}
 
-			outInstance.vehicles = vehicles;
-			outInstance.initialPositions = initialPositions;
-			outInstance.waitingStations = waitingStations;
+			//only one scenario is read, so these are moved
+			outInstance.vehicles = std::move(vehicles);
+			outInstance.initialPositions = std::move(initialPositions);
+			outInstance.waitingStations = std::move(waitingStations);
 			for(int i = 0; i < outInstance.waitingStations.size(); i++)
 			{
 				int w_id = outInstance.vehicles.size() + 2 * nbRequests + i;
@@ -685,60 +663,38 @@ bool ProblemData::readVincentInstance(string requests_path, string hospitals_pat
 			outInstance.destinations.reserve(nbRequests);
 			for(int i = 0; i < nbRequests; i++)
 			{
-				if(!std::getline(infile, line) ) throw std::invalid_argument("unexpected file format : missing line");
-				std::istringstream iss(line);
-				
-				
-				if(!tenColumns)
-				{
-					//line order
-					//Time - Region index - Priority - Day - Time on scene - Lat - Long - Time at hospital - TimeCleaningBase - Cleaning needed - Hospital needed - index hospital - index_cleaning
-
-					/*
-						index_cleaning has been added recently, it represents the cleaning location where the ambulance should be sent
-						however, I have not implemented this
-					*/
-
-					if (!(iss >> time >> region_index >> priority >> day >> time_on_scene >> lat >> lon >> time_at_hospital >> time_cleaning_base >> cleaning_needed >> hospital_needed >> index_hospital >> index_cleaning)) {
-						throw std::invalid_argument("unexpected file format : misread line data");
-					}
-				}
-				else
-				{
-					//Time Lat Long Priority Cleaning_needed Cleaning_time Index hospital Time_on_scene Hospital needed Time at hospital
-					if (!(iss >> time >> lon >> lat >> priority >> cleaning_needed >> time_cleaning_base >> index_hospital >> time_on_scene >> hospital_needed >> time_at_hospital)) {
-						throw std::invalid_argument("unexpected file format : misread line data");
-					}
-				}
-				
-				
+				/*
+					index_cleaning has been added recently to the 13 columns format, it represents the cleaning location where the ambulance should be sent
+					the 10 columns format doesn't have it, so the first cleaning base is used
+				*/
+				const Call &call = calls[i];
 
 				Position pos; 
 
-				pos.x = lon; 
-				pos.y = lat;
+				pos.x = call.lon; 
+				pos.y = call.lat;
 
 				Request req; req.id = outInstance.initialPositions.size() + i; req.identifier = req.id;
 				req.position = pos;
-				req.arrival_time = time; //will be multiplied by 3600 later
+				req.arrival_time = call.time; //will be multiplied by 3600 later
 				req.destination = req.id + nbRequests; //temporarily store hospital index here, will be fixed later
 
 				//
 				//*3600 because file is in fractions of hours
-				req.service_time = time_on_scene * 3600 + time_at_hospital * 3600;
+				req.service_time = call.timeOnScene * 3600 + call.timeAtHospital * 3600;
 
 				//time_on_scene and index_hospital
 				
-				req.type = priority;
-				if(priority == 0)
+				req.type = call.priority;
+				if(call.priority == 0)
 				{
 					req.weight = 4;
 				}
-				else if(priority == 1)
+				else if(call.priority == 1)
 				{
 					req.weight = 2;
 				}
-				else if(priority == 2)
+				else if(call.priority == 2)
 				{
 					req.weight = 1;
 				}
@@ -761,10 +717,10 @@ bool ProblemData::readVincentInstance(string requests_path, string hospitals_pat
 				// cheating out cleaning requirements in this model:
 				// 1st cleaning time is added to service time
 				// see below for distance adjustments 
-				if(cleaning_needed)
+				if(call.cleaningNeeded)
 				{
-					req.service_time += time_cleaning_base * 3600;
-					reqToCleaningBaseIndex.push_back(index_cleaning);
+					req.service_time += call.timeCleaningBase * 3600;
+					reqToCleaningBaseIndex.push_back(call.indexCleaning);
 				}
 				else reqToCleaningBaseIndex.push_back(-1);
 				
@@ -773,11 +729,12 @@ bool ProblemData::readVincentInstance(string requests_path, string hospitals_pat
 				//positions[req.id] = pos;
 
 				//if hospital isn't needed, to do (set destination to same as request, set times to zero)
-				assert(hospital_needed);
+				assert(call.hospitalNeeded);
 
 				Destination dest;
 				dest.id = req.id + nbRequests; dest.identifier = dest.id;
-				dest.position = hospitalPositions[(int) index_hospital];
+				dest.position = hospitalPositions[(int) call.indexHospital];
+				reqToHospitalIndex.push_back((int) call.indexHospital);
 				dest.projected = false;
 
 				outInstance.destinations.push_back(dest);
@@ -790,95 +747,49 @@ bool ProblemData::readVincentInstance(string requests_path, string hospitals_pat
 			//vertices are ordered: initial_positions, requests, destination, waiting_stations
 			vector<Vertex*> vertices;
 			vertices.resize(nbVertices);
-			for (int i = 0; i < initialPositions.size(); i++) vertices[i] = &outInstance.initialPositions[i];
+			for (int i = 0; i < (int) outInstance.initialPositions.size(); i++) vertices[i] = &outInstance.initialPositions[i];
 			for (int i = 0; i < outInstance.requests.size(); i++) vertices[nbVehicles + i] = &outInstance.requests[i];
 			for (int i = 0; i < outInstance.destinations.size(); i++) vertices[nbVehicles + nbRequests + i] = &outInstance.destinations[i];
-			for (int i = 0; i < waitingStations.size(); i++) vertices[nbVehicles + 2 * nbRequests + i] = &outInstance.waitingStations[i];
+			for (int i = 0; i < (int) outInstance.waitingStations.size(); i++) vertices[nbVehicles + 2 * nbRequests + i] = &outInstance.waitingStations[i];
 
 			outInstance.distanceType = useOSM ? DistanceType::osrm : DistanceType::geodesic;
 
-			// 1st step: fill cleaning cases in distance matrix
+			// 1st step: request -> destination distances, because of the cleaning bases cheat
 			/* For each request demanding cleaning:
 				- set its distance to destination to original distance + distance from destination to cleaning base
 				- change destination's coordinates to cleaning base
 
-			after this is done, calculate other coordinates
+			this is done for every request before any other distance is calculated, so that those use the final destination positions
 			*/
+			vector<int> infrastructureSites(nbVertices, -1);
+			for(int i = 0; i < nbVehicles; i++) infrastructureSites[i] = infrastructure->BaseSite(initialPositionBases[i]);
+			for(int i = 0; i < (int) outInstance.waitingStations.size(); i++) infrastructureSites[nbVehicles + 2 * nbRequests + i] = infrastructure->BaseSite(i);
 
-			vector<vector<double>> distances = vector<vector<double>>();
-			distances.reserve(nbVertices);
-			//initialize empty:
-			for(int i = 0; i < vertices.size(); i++)
-			{
-				vector<double> tVec(vertices.size(), -1.0);
-				distances.push_back(tVec);
-			}
-			
-			//first, do all req->dest pairs, because of cleaning bases cheat
+			vector<double> requestToDestination(nbRequests);
 			for(int iReq = 0; iReq < outInstance.NbRequests(); iReq++)
 			{
 				const Request *req = outInstance.GetRequestByIndex(iReq);
 				Destination *dest = &outInstance.destinations[outInstance.DestinationIdToIndex(req->destination)];
+				requestToDestination[iReq] = calculateDistance(req->position, dest->position, outInstance.distanceType);
+				infrastructureSites[dest->id] = infrastructure->HospitalSite(reqToHospitalIndex[iReq]);
 				if(reqToCleaningBaseIndex[iReq] != -1)
 				{
 					//this request requires cleaning. Adjust distances and coordinates accordingly
 					int cleaningIndex = reqToCleaningBaseIndex[iReq];
-					assert(cleaningIndex >= 0 && cleaningIndex < cleaningBases.size());
-					distances[req->id][req->destination] = calculateDistance(req->position, dest->position, outInstance.distanceType) + calculateDistance(dest->position, cleaningBases[cleaningIndex], outInstance.distanceType);
+					assert(cleaningIndex >= 0 && cleaningIndex < infrastructure->NbCleaningBases());
+					requestToDestination[iReq] += infrastructure->HospitalToCleaningBase(reqToHospitalIndex[iReq], cleaningIndex);
 					
 					// the destination's position is changed to the cleaning base, since this is where the service actually ends
-					dest->position = cleaningBases[cleaningIndex];
+					dest->position = infrastructure->CleaningBases()[cleaningIndex];
+					infrastructureSites[dest->id] = infrastructure->CleaningBaseSite(cleaningIndex);
 
 					//unfortunately we're losing data here, but these positions won't be necessary anyway
 				}
-				else
-				{
-					distances[req->id][req->destination] = calculateDistance(req->position, dest->position, outInstance.distanceType);
-				}
-
-				// 2nd step: calculate temp matrix of real distances
-				// (by using this intermediate matrix we're calculating some useless distances, but calculating them individually is bad in the OSRM case and elimating the repeated pairs before calculations is a nightmare)
-				vector<vector<double>> temp_matrix;
-				CalculateDistanceMatrix(vertices, temp_matrix, outInstance.distanceType);
-
-				//3rd step: fill out everyone else and don't alter req->dest pairs
-				for (int i = 0; i < nbVertices; i++)
-				{
-					for (int j = 0; j < nbVertices; j++)
-					{
-						if (i == j) 
-						{
-							distances[i][j] = 0.0;
-							continue;
-						}
-						else if(outInstance.IsRequest(i) && outInstance.IsDestination(j))
-						{
-							const Request *req = outInstance.GetRequest(i);
-							const Destination *dest = outInstance.GetDestination(j);
-							if(req->destination == dest->id) //if this is a req - dest pair
-							{
-								//already calculated above, dont change it!
-								continue;
-							}
-						}
-
-						distances[i][j] = temp_matrix[i][j]; 
-					}
-				}
-
-				outInstance.distances = distances;
 			}
 
-			#ifdef _DEBUG
-			//verify if all values have been initialized
-			for(int i = 0; i < vertices.size(); i++)
-			{
-				for(int j = 0; j < vertices.size(); j++)
-				{
-					assert(outInstance.distances[i][j] < 0);
-				}
-			}
-			#endif
+			// 2nd step: every other distance the matrix stores, each calculated once. Request -> destination pairs come from the 1st step,
+			// and the distances from bases, hospitals and cleaning bases to waiting stations are copied from the infrastructure
+			outInstance.CalculateDistances(vertices, &requestToDestination, &infrastructureSites);
 
 			//fix request arrival times:
 			// get initial time over all requests , then use floor
@@ -894,6 +805,7 @@ bool ProblemData::readVincentInstance(string requests_path, string hospitals_pat
 			}
 
 			outInstance.PrecomputeClosestWSs();
+			outInstance.ComputeVehicleClasses();
 
 			outInstance.Validate();
 
@@ -902,8 +814,168 @@ bool ProblemData::readVincentInstance(string requests_path, string hospitals_pat
 
 	}
 
-	return false;
+}
+
+//compiled instance file layout: CompiledHeader, then the sections of CompiledLayout, each at an offset multiple of 8
+struct CompiledHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t structSizes[5]; //Vehicle, InitialPosition, Request, Destination, WaitingStation
+	int32_t nbVehicles;
+	int32_t nbRequests;
+	int32_t nbWaitingStations;
+	int32_t nameLength;
+	int32_t distanceType;
+	int32_t waitingStationPolicy;
+	uint8_t computeTimeHorizon;
+	uint8_t allowRerouting;
+	uint8_t useTargetWaitTimeObjective;
+	double timeHorizon;
+	uint64_t distanceBytes;
+	uint64_t fileSize;
+};
+static const char compiledMagic[8] = {'S', 'A', 'V', 'R', 'P', 'I', 'N', '\0'};
+static const uint32_t compiledVersion = 1; //bump whenever the stored members, the header or DistanceMatrix's layout change
+static const uint32_t compiledStructSizes[5] = {sizeof(Vehicle), sizeof(InitialPosition), sizeof(Request), sizeof(Destination), sizeof(WaitingStation)};
+
+//vertices and vehicles are stored as they are in memory
+static_assert(std::is_trivially_copyable<Vehicle>::value && std::is_trivially_copyable<InitialPosition>::value && std::is_trivially_copyable<Request>::value
+	&& std::is_trivially_copyable<Destination>::value && std::is_trivially_copyable<WaitingStation>::value, "compiled instances copy these as bytes");
+
+struct CompiledLayout
+{
+	size_t name, vehicles, initialPositions, requests, destinations, waitingStations, vehicleClassOf, distances, size;
+
+	explicit CompiledLayout(const CompiledHeader &header)
+	{
+		size_t offset = sizeof(CompiledHeader);
+		auto section = [&offset](size_t bytes)
+		{
+			offset = (offset + 7) / 8 * 8;
+			size_t start = offset;
+			offset += bytes;
+			return start;
+		};
+		name = section(header.nameLength);
+		vehicles = section((size_t) header.nbVehicles * sizeof(Vehicle));
+		initialPositions = section((size_t) header.nbVehicles * sizeof(InitialPosition));
+		requests = section((size_t) header.nbRequests * sizeof(Request));
+		destinations = section((size_t) header.nbRequests * sizeof(Destination));
+		waitingStations = section((size_t) header.nbWaitingStations * sizeof(WaitingStation));
+		vehicleClassOf = section((size_t) header.nbVehicles * sizeof(int32_t));
+		distances = section(header.distanceBytes);
+		size = offset;
+	}
+};
 
+void ProblemData::writeCompiledInstance(string path) const
+{
+	assert(distances.Precision() == DistancePrecision::float64);
+	assert(initialPositions.size() == vehicles.size() && vehicleClassOf.size() == vehicles.size());
+
+	CompiledHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, compiledMagic, sizeof(compiledMagic));
+	header.version = compiledVersion;
+	memcpy(header.structSizes, compiledStructSizes, sizeof(compiledStructSizes));
+	header.nbVehicles = NbVehicles();
+	header.nbRequests = NbRequests();
+	header.nbWaitingStations = NbWaitingStations();
+	header.nameLength = name.size();
+	header.distanceType = (int32_t) distanceType;
+	header.waitingStationPolicy = (int32_t) waitingStationPolicy;
+	header.computeTimeHorizon = computeTimeHorizon;
+	header.allowRerouting = allowRerouting;
+	header.useTargetWaitTimeObjective = useTargetWaitTimeObjective;
+	header.timeHorizon = timeHorizon;
+	header.distanceBytes = distances.MemoryUsage();
+
+	CompiledLayout layout(header);
+	header.fileSize = layout.size;
+
+	vector<char> file(layout.size, 0);
+	vector<int32_t> classes(vehicleClassOf.begin(), vehicleClassOf.end());
+	memcpy(file.data(), &header, sizeof(header));
+	memcpy(file.data() + layout.name, name.data(), name.size());
+	memcpy(file.data() + layout.vehicles, vehicles.data(), vehicles.size() * sizeof(Vehicle));
+	memcpy(file.data() + layout.initialPositions, initialPositions.data(), initialPositions.size() * sizeof(InitialPosition));
+	memcpy(file.data() + layout.requests, requests.data(), requests.size() * sizeof(Request));
+	memcpy(file.data() + layout.destinations, destinations.data(), destinations.size() * sizeof(Destination));
+	memcpy(file.data() + layout.waitingStations, waitingStations.data(), waitingStations.size() * sizeof(WaitingStation));
+	memcpy(file.data() + layout.vehicleClassOf, classes.data(), classes.size() * sizeof(int32_t));
+	memcpy(file.data() + layout.distances, distances.Data(), header.distanceBytes);
+
+	std::ofstream out(path, std::ios::binary);
+	out.write(file.data(), file.size());
+	out.close();
+	if(!out) throw std::runtime_error("could not write " + path);
+}
+
+void ProblemData::readCompiledInstance(string path, ProblemData &outInstance)
+{
+	int fd = open(path.c_str(), O_RDONLY);
+	if(fd < 0) throw std::invalid_argument("file not found : " + path);
+
+	struct stat st;
+	void* mapped = MAP_FAILED;
+	if(fstat(fd, &st) == 0 && st.st_size >= (off_t) sizeof(CompiledHeader)) mapped = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	//the mapping stays valid after closing
+	close(fd);
+	if(mapped == MAP_FAILED) throw std::invalid_argument("unexpected file format: " + path);
+
+	size_t length = st.st_size;
+	std::shared_ptr<const void> file(mapped, [length](const void* p) { munmap(const_cast<void*>(p), length); });
+	const char* bytes = static_cast<const char*>(mapped);
+
+	const CompiledHeader* header = static_cast<const CompiledHeader*>(mapped);
+	if(memcmp(header->magic, compiledMagic, sizeof(compiledMagic)) != 0 || header->version != compiledVersion
+		|| memcmp(header->structSizes, compiledStructSizes, sizeof(compiledStructSizes)) != 0)
+	{
+		throw std::invalid_argument("unexpected file format (convert it again with this version): " + path);
+	}
+	if(header->nbVehicles < 0 || header->nbRequests < 0 || header->nbWaitingStations < 0 || header->nameLength < 0
+		|| header->fileSize != length || CompiledLayout(*header).size != length)
+	{
+		throw std::invalid_argument("unexpected file format: " + path);
+	}
+	CompiledLayout layout(*header);
+
+	outInstance = ProblemData();
+	outInstance.name = string(bytes + layout.name, header->nameLength);
+	outInstance.timeHorizon = header->timeHorizon;
+	outInstance.computeTimeHorizon = header->computeTimeHorizon;
+	outInstance.allowRerouting = header->allowRerouting;
+	outInstance.waitingStationPolicy = (WaitingStationPolicy) header->waitingStationPolicy;
+	outInstance.useTargetWaitTimeObjective = header->useTargetWaitTimeObjective;
+	outInstance.distanceType = (DistanceType) header->distanceType;
+
+	const Vehicle* vehicles = reinterpret_cast<const Vehicle*>(bytes + layout.vehicles);
+	const InitialPosition* initialPositions = reinterpret_cast<const InitialPosition*>(bytes + layout.initialPositions);
+	const Request* requests = reinterpret_cast<const Request*>(bytes + layout.requests);
+	const Destination* destinations = reinterpret_cast<const Destination*>(bytes + layout.destinations);
+	const WaitingStation* waitingStations = reinterpret_cast<const WaitingStation*>(bytes + layout.waitingStations);
+	const int32_t* vehicleClassOf = reinterpret_cast<const int32_t*>(bytes + layout.vehicleClassOf);
+	outInstance.vehicles.assign(vehicles, vehicles + header->nbVehicles);
+	outInstance.initialPositions.assign(initialPositions, initialPositions + header->nbVehicles);
+	outInstance.requests.assign(requests, requests + header->nbRequests);
+	outInstance.destinations.assign(destinations, destinations + header->nbRequests);
+	outInstance.waitingStations.assign(waitingStations, waitingStations + header->nbWaitingStations);
+
+	//classes are listed by increasing vehicle id
+	outInstance.vehicleClassOf.assign(vehicleClassOf, vehicleClassOf + header->nbVehicles);
+	outInstance.vehicleClasses.clear();
+	for(int i = 0; i < (int) outInstance.vehicleClassOf.size(); i++)
+	{
+		int c = outInstance.vehicleClassOf[i];
+		if(c < 0 || c > (int) outInstance.vehicleClasses.size()) throw std::invalid_argument("unexpected file format: " + path);
+		if(c == (int) outInstance.vehicleClasses.size()) outInstance.vehicleClasses.emplace_back();
+		outInstance.vehicleClasses[c].push_back(i);
+	}
+
+	//the distances stay in the mapping, which they keep alive
+	std::shared_ptr<const void> distances(file, bytes + layout.distances);
+	outInstance.distances = DistanceMatrix::FromBuffer(header->nbVehicles, header->nbRequests, header->nbWaitingStations, distances, header->distanceBytes).WithPrecision(distancePrecision);
 }
 
 const InitialPosition* ProblemData::GetInitialPositionByIndex(int index) const
@@ -1130,6 +1202,19 @@ void ProblemData::PrecomputeClosestWSs()
 		waitingStations[i].closestWaitingStation = initialPositions[i].id;
 	}
 }
+
+//index of the smallest of the first n distances of row, the first one on ties
+template <class T>
+static int ClosestIndex(DistanceRow<T> row, int n)
+{
+	int closest = -1;
+	for(int i = 0; i < n; i++)
+	{
+		if(closest == -1 || row[closest] > row[i]) closest = i;
+	}
+	return closest;
+}
+
 int ProblemData::GetClosestWaitingStation(int vertexId) const
 {
 	assert(vertexId >= 0 && vertexId < NbVertices());
@@ -1137,49 +1222,15 @@ int ProblemData::GetClosestWaitingStation(int vertexId) const
 
 	if(IsWaitingStation(vertexId)) return vertexId;
 
-	double minDist = HUGE_VAL;
-	int ws_id = -1;
-
 	//vertices are ordered: initial_positions, requests, destination, waiting_stations
 	int first = NbVehicles() + 2*NbRequests();
-	int last = first + NbWaitingStations();
-	for(int i = first; i < last; i++)
-	{
-		if(ws_id == -1 || minDist > distances[vertexId][i])
-		{
-			minDist = distances[vertexId][i];
-			ws_id = i;
-		}
-	}
+	int ws_id = first + (distances.Precision() == DistancePrecision::float32 ? ClosestIndex(distances.ToWaitingStations<float>(vertexId), NbWaitingStations())
+		: ClosestIndex(distances.ToWaitingStations<double>(vertexId), NbWaitingStations()));
 
 	assert(IsWaitingStation(ws_id));
 	return ws_id;
 }
 
-int ProblemData::GetClosestDestination(int vertexId) const
-{
-	assert(vertexId >= 0 && vertexId < NbVertices());
-	assert(!IsDestination(vertexId));
-
-	double minDist = HUGE_VAL;
-	int dest_id = -1;
-
-	//vertices are ordered: initial_positions, requests, destination, waiting_stations
-	int first = NbVehicles() + NbRequests();
-	int last = first + NbRequests();
-	for(int i = first; i < last; i++)
-	{
-		if(dest_id == -1 || minDist > distances[vertexId][i])
-		{
-			minDist = distances[vertexId][i];
-			dest_id = i;
-		}
-	}
-
-	assert(IsDestination(dest_id));
-	return dest_id;
-}
-
 // void ProblemData::UpdateDistanceMatrix()
 // {
 // 	std::cout << "UpdateDistanceMatrix" << std::endl;
@@ -1301,7 +1352,7 @@ double ProblemData::OmmitedDistance(int i, int j)
 		//moving from request to sink: that is servicing the request + 0.0
 		const Request* req = GetRequest(i);
 		int destination = req->destination;
-		return req->service_time + distances[i][destination];
+		return req->service_time + distances(i, destination);
 	}
 	else if (IsRequest(i))
 	{
@@ -1309,19 +1360,13 @@ double ProblemData::OmmitedDistance(int i, int j)
 		//thus: service_time + move time from i to destination + move time from destination to j
 		const Request* req = GetRequest(i);
 		int destination = req->destination;
-		return req->service_time + distances[i][destination] + distances[destination][j];
+		return req->service_time + distances(i, destination) + Distance(destination, j);
 	}
 	else if (j > NbVertices())
 	{
 		return 0.0;
 	}
-	else return distances[i][j];
-}
-
-double ProblemData::Distance(int i, int j)
-{
-	assert(i >= 0 && j >= 0 && i < NbVertices() && j < NbVertices());
-	return distances[i][j];
+	else return Distance(i, j);
 }
 
 double ProblemData::calculateDistance(const Position& pos1, const Position& pos2, DistanceType distanceType)
@@ -1383,6 +1428,86 @@ void ProblemData::SetVehiclePositions(vector<Position> vehiclePositions)
 	{
 		initialPositions[i].position = vehiclePositions[i];
 	}
+
+	ComputeVehicleClasses();
+}
+
+const TransitionTable* ProblemData::GetTransitionTable() const
+{
+	if(transitionTable == NULL || !transitionTable->Matches(this)) return NULL;
+	return transitionTable.get();
+}
+
+const NgNeighbourhoods* ProblemData::GetNgNeighbourhoods() const
+{
+	if(ngNeighbourhoods == NULL || !ngNeighbourhoods->Matches(this)) return NULL;
+	return ngNeighbourhoods.get();
+}
+
+//are the distances from initial positions id1 and id2 to the requests and waiting stations the same?
+template <class T>
+static bool SameStoredDistances(const DistanceMatrix &distances, int id1, int id2)
+{
+	DistanceRow<T> toRequests1 = distances.ToRequests<T>(id1), toRequests2 = distances.ToRequests<T>(id2);
+	for(int j = 0; j < distances.NbRequests(); j++)
+	{
+		if(toRequests1[j] != toRequests2[j]) return false;
+	}
+	DistanceRow<T> toStations1 = distances.ToWaitingStations<T>(id1), toStations2 = distances.ToWaitingStations<T>(id2);
+	for(int j = 0; j < distances.NbWaitingStations(); j++)
+	{
+		if(toStations1[j] != toStations2[j]) return false;
+	}
+	return true;
+}
+
+bool ProblemData::AreVehiclesEquivalent(int veh1, int veh2) const
+{
+	const Vehicle &v1 = vehicles[veh1];
+	const Vehicle &v2 = vehicles[veh2];
+	if(v1.type != v2.type || v1.timeAvailable != v2.timeAvailable || v1.preferredWaitingStation != v2.preferredWaitingStation) return false;
+
+	const Position &p1 = GetInitialPosition(veh1)->position;
+	const Position &p2 = GetInitialPosition(veh2)->position;
+	if(p1.x != p2.x || p1.y != p2.y) return false;
+
+	//same position should mean same distances, but the matrix is what the pricing actually reads (and it isn't recomputed by SetVehiclePositions)
+	if(distances.NbVertices() == NbVertices())
+	{
+		//only distances towards requests and waiting stations are stored from an initial position
+		int id1 = InitialPositionIndexToId(veh1);
+		int id2 = InitialPositionIndexToId(veh2);
+		if(distances.Precision() == DistancePrecision::float32) return SameStoredDistances<float>(distances, id1, id2);
+		return SameStoredDistances<double>(distances, id1, id2);
+	}
+
+	return true;
+}
+
+void ProblemData::ComputeVehicleClasses()
+{
+	vehicleClasses.clear();
+	vehicleClassOf.assign(vehicles.size(), -1);
+
+	//compare each vehicle against the first member of each class found so far
+	for(int i = 0; i < (int) vehicles.size(); i++)
+	{
+		for(int c = 0; c < (int) vehicleClasses.size(); c++)
+		{
+			if(AreVehiclesEquivalent(vehicleClasses[c][0], i))
+			{
+				vehicleClassOf[i] = c;
+				vehicleClasses[c].push_back(i);
+				break;
+			}
+		}
+
+		if(vehicleClassOf[i] == -1)
+		{
+			vehicleClassOf[i] = vehicleClasses.size();
+			vehicleClasses.push_back(vector<int>(1, i));
+		}
+	}
 }
 
 
@@ -250,7 +250,9 @@ void Route::SetArrivalsAndDepartures(ProblemData *problemData)
 #ifdef _DEBUG
 	for(int i = 1; i < vertices.size() - 1; i++)
 	{
-		assert(std::abs(departure_times[i] - (arrival_times[i+1] - problemData->Distance(vertices[i].id, vertices[i+1].id)) < RC_EPS);
+		//departure from a request is from its destination
+		int from = problemData->IsRequest(vertices[i].id) ? problemData->GetRequest(vertices[i].id)->destination : vertices[i].id;
+		assert(std::abs(departure_times[i] - (arrival_times[i+1] - problemData->Distance(from, vertices[i+1].id))) < RC_EPS);
 		assert(departure_times[i] > arrival_times[i] - RC_EPS);
 	}
 	departure_times[departure_times.size() - 1] = std::numeric_limits<double>::infinity();
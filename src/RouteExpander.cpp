@@ -4,8 +4,115 @@
 
 #define RC_EPS 0.1
 
+#include <algorithm>
+
+std::shared_ptr<const TransitionTable> TransitionTable::Build(ProblemData *problemData)
+{
+    WaitingStationPolicy wsPolicy = problemData->waitingStationPolicy;
+    if(wsPolicy != WaitingStationPolicy::optionalStopInClosestWaitingStation && wsPolicy != WaitingStationPolicy::bestOptionalStop)
+        return NULL; //preferred station depends on the vehicle
+
+    //constructor is private
+    std::shared_ptr<TransitionTable> table(new TransitionTable());
+
+    int n = problemData->NbRequests();
+    table->nbRequests = n;
+    table->policy = wsPolicy;
+    table->allowRerouting = problemData->allowRerouting;
+    table->timeHorizon = problemData->timeHorizon;
+
+    table->readyOffset.resize(n);
+    table->arrivalTimes.resize(n);
+    for(int i = 0; i < n; i++)
+    {
+        const Request* req = problemData->GetRequestByIndex(i);
+        table->readyOffset[i] = req->service_time + problemData->Distance(req->id, req->destination);
+        table->arrivalTimes[i] = req->arrival_time;
+    }
+
+    table->transitions.resize((size_t) n * n);
+
+    if(problemData->Distances().Precision() == DistancePrecision::float32) table->BuildTransitions<float>(problemData);
+    else table->BuildTransitions<double>(problemData);
+
+    return table;
+}
+
+template <class T>
+void TransitionTable::BuildTransitions(ProblemData *problemData)
+{
+    WaitingStationPolicy wsPolicy = policy;
+    int n = nbRequests;
+
+    vector<WSOption> candidates;
+    candidates.reserve(problemData->NbWaitingStations());
+    for(int i = 0; i < n; i++)
+    {
+        const Request* lastRequest = problemData->GetRequestByIndex(i);
+        int startId = lastRequest->destination;
+
+        DistanceRow<T> startToRequests = problemData->Distances().ToRequests<T>(startId);
+        DistanceRow<T> startToStations = problemData->Distances().ToWaitingStations<T>(startId);
+        for(int j = 0; j < n; j++)
+        {
+            const Request* nextRequest = problemData->GetRequestByIndex(j);
+            DistanceRow<T> toNextRequest = problemData->Distances().FromWaitingStations<T>(nextRequest->id);
+            Transition &tr = transitions[(size_t) i * n + j];
+            tr.direct = startToRequests[j];
+
+            candidates.clear();
+            if(wsPolicy == WaitingStationPolicy::bestOptionalStop)
+            {
+                for(int ws_i = 0; ws_i < problemData->NbWaitingStations(); ws_i++)
+                {
+                    int ws_id = problemData->GetWaitingStationByIndex(ws_i)->id;
+                    candidates.push_back({startToStations[ws_i], toNextRequest[ws_i], ws_id});
+                }
+            }
+            else
+            {
+                //same as checkRouteExpansion: closest to the last request, not to its destination
+                int ws_id = lastRequest->closestWaitingStation;
+                candidates.push_back({problemData->Distance(startId, ws_id), problemData->Distance(ws_id, nextRequest->id), ws_id});
+            }
+
+            //rerouting happens at some ws k if t' + toWS_k > arrival_j
+            double maxToWS = -HUGE_VAL;
+            for(const WSOption &option : candidates) maxToWS = std::max(maxToWS, option.toWS);
+            tr.reroutingFrom = allowRerouting ? nextRequest->arrival_time - maxToWS : HUGE_VAL;
+
+            //keep only non dominated options: increasing toWS + fromWS and strictly decreasing fromWS (thus increasing toWS)
+            std::sort(candidates.begin(), candidates.end(), [](const WSOption &a, const WSOption &b)
+            { 
+                double ta = a.toWS + a.fromWS, tb = b.toWS + b.fromWS;
+                return ta < tb || (ta == tb && a.fromWS < b.fromWS);
+            });
+
+            tr.firstOption = options.size();
+            double bestFromWS = HUGE_VAL;
+            for(const WSOption &option : candidates)
+            {
+                if(option.fromWS < bestFromWS)
+                {
+                    options.push_back(option);
+                    bestFromWS = option.fromWS;
+                }
+            }
+            tr.nbOptions = options.size() - tr.firstOption;
+        }
+    }
+}
+
 
 bool RouteExpander::checkRouteExpansion(ProblemData *problemData, int vehicle_id, const Request* nextRequest, const Vertex* lastVertex, double lastVertexArrivalTime, double& outTime, int& outWaitingStationId, bool &outUseIntermediateIntermediateVertex,  IntermediateVertex &outIntermediateVertex)
+{
+    if(problemData->Distances().Precision() == DistancePrecision::float32)
+        return checkRouteExpansionAs<float>(problemData, vehicle_id, nextRequest, lastVertex, lastVertexArrivalTime, outTime, outWaitingStationId, outUseIntermediateIntermediateVertex, outIntermediateVertex);
+    return checkRouteExpansionAs<double>(problemData, vehicle_id, nextRequest, lastVertex, lastVertexArrivalTime, outTime, outWaitingStationId, outUseIntermediateIntermediateVertex, outIntermediateVertex);
+}
+
+template <class T>
+bool RouteExpander::checkRouteExpansionAs(ProblemData *problemData, int vehicle_id, const Request* nextRequest, const Vertex* lastVertex, double lastVertexArrivalTime, double& outTime, int& outWaitingStationId, bool &outUseIntermediateIntermediateVertex,  IntermediateVertex &outIntermediateVertex)
 {
     assert(problemData != NULL);
     assert(problemData->IsInitialPosition(lastVertex->id) || problemData->IsRequest(lastVertex->id));
@@ -79,6 +186,10 @@ bool RouteExpander::checkRouteExpansion(ProblemData *problemData, int vehicle_id
         IntermediateVertex bestIntermediateVertex;
         bool bestUseIntermediate;
 
+        //distances from startVertex and to nextRequest, so that the best station loop reads contiguous memory
+        DistanceRow<T> startToStations = problemData->Distances().ToWaitingStations<T>(startVertex->id);
+        DistanceRow<T> toNextRequest = problemData->Distances().FromWaitingStations<T>(nextRequest->id);
+
         // iterate all and find best one:
         // if we don't really need to iterate, this for is degenerate, uses < 1 and ignores the counter
         for(int ws_i = 0; ws_i < (whichStation == WhichStation::best ? problemData->NbWaitingStations() : 1); ws_i++)
@@ -99,9 +210,10 @@ bool RouteExpander::checkRouteExpansion(ProblemData *problemData, int vehicle_id
 
             assert(ws_id != -1);
             const WaitingStation* ws = problemData->GetWaitingStation(ws_id);
+            double toWS = whichStation == WhichStation::best ? startToStations[ws_i] : problemData->Distance(startVertex->id, ws_id);
+            double fromWS = whichStation == WhichStation::best ? toNextRequest[ws_i] : problemData->Distance(ws_id, nextRequest->id);
             
-            double arriveAtWS = firstAvailable
-                                + problemData->Distance(startVertex->id, ws->id);
+            double arriveAtWS = firstAvailable + toWS;
 
             double firstLeaveWS = arriveAtWS;
 
@@ -114,12 +226,6 @@ bool RouteExpander::checkRouteExpansion(ProblemData *problemData, int vehicle_id
 
                 //this rerouting strategy is supposing that everything is geodesic. To-do: generalize this
 
-                //sanity checks on intermediate positions:
-                //both should be the halfway between points...
-                double dist = problemData->Distance(startVertex->id, ws->id);
-                Position pos1 = ProblemData::GetIntermediatePosition(startVertex->position, ws->position, firstAvailable, firstAvailable + problemData->Distance(startVertex->id, ws->id) / 2.0);
-                Position pos2 = ProblemData::GetIntermediatePosition2(startVertex->position, ws->position, problemData->Distance(startVertex->id, ws->id) / 2.0);
-
                 //
                 Position intermediatePos = ProblemData::GetIntermediatePosition(startVertex->position, ws->position, firstAvailable, nextRequest->arrival_time);
 
@@ -157,7 +263,7 @@ bool RouteExpander::checkRouteExpansion(ProblemData *problemData, int vehicle_id
                 //rerouting was actually better than stopping at ws?
                 
                 //unfortunately, both of these reasonable assumptions may fail, apparently because of precision errors in coordinate and trigonometric operations!
-                double alt = std::max(firstLeaveWS, nextRequest->arrival_time) + problemData->Distance(ws->id, nextRequest->id);
+                double alt = std::max(firstLeaveWS, nextRequest->arrival_time) + fromWS;
                 assert(abs((firstAvailable + t1) - nextRequest->arrival_time) < RC_EPS);
                 assert(newTime < alt + RC_EPS);
 
@@ -165,7 +271,7 @@ bool RouteExpander::checkRouteExpansion(ProblemData *problemData, int vehicle_id
             else
             {
                 newTime = std::max(firstLeaveWS, nextRequest->arrival_time) //adjust for non-antecipativity
-                            + problemData->Distance(ws->id, nextRequest->id);
+                            + fromWS;
                 hasRerouted = false;
             }
 
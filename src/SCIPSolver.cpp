@@ -3,6 +3,7 @@
 #include <vector>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 
 #include <boost/filesystem.hpp>
 
@@ -149,11 +150,34 @@ SCIP_RETCODE runSCIP(Params* params, ProblemData* problemData, ProblemSolution &
 
    std::string commit_hash = GIT_COMMIT_HASH;
 
+   //rounds/hits/time of each pricing tier, in order
+   std::ostringstream tierStats;
+   for(int t = 0; t < summary.nbPricingTiers; t++)
+   {
+      if(t > 0) tierStats << ";";
+      tierStats << summary.tierRounds[t] << "/" << summary.tierHits[t] << "/" << summary.tierTime[t];
+   }
+
+   /*
+      time/closure of each root round that improved the Lagrangian bound. Closure is the fraction of the gap between the first bound 
+      and the LP objective of the last entry closed so far. It reaches 1 if the root converged
+   */
+   std::ostringstream rootGapClosure;
+   const vector<double> &trace = summary.rootBoundTrace;
+   for(size_t k = 0; k + 2 < trace.size(); k += 3)
+   {
+      double initialGap = trace[trace.size() - 1] - trace[1];
+      double closure = initialGap > 0.0 ? (trace[k + 1] - trace[1]) / initialGap : 1.0;
+      if(k > 0) rootGapClosure << ";";
+      rootGapClosure << trace[k] << "/" << closure;
+   }
+
    std::scientific(myfile);
 	myfile.precision(std::numeric_limits<double>::max_digits10);
 
    //myfile.write(problemData->name.c_str(), (problemData->name.size() + 1) * sizeof(char) );
 
+   //columns up to the repeated routes' reduced cost keep their original positions. Newer ones go after them, variable length ones (';' separated) last
    myfile   << problemData->name << "," << params->descriptiveString << "," << problemData->NbRequests() << "," << problemData->NbVehicles() << "," << problemData->timeHorizon << "," << (int) problemData->waitingStationPolicy << ","
             << solution.cost << "," << solution.route_cost << "," << solution.penalty_cost << "," << solution.routes.size() << "," << avg_requests_per_route << "," << max_req_in_route << "," << has_cycles << ","
             << responseSummary.nServiced << "," << responseSummary.nNotServiced << ","
@@ -167,6 +191,18 @@ SCIP_RETCODE runSCIP(Params* params, ProblemData* problemData, ProblemSolution &
             << summary.timesBranchedWithRule[0] << "," << summary.timesBranchedWithRule[1] << "," << summary.timesBranchedWithRule[2] << ","
             << (int) params->pricingAlgorithm << "," << params->timeout << "," << params->solveRelaxedProblem << "," << params->newRoutesPerPricing << "," << problemData->allowRerouting << "," << params->heuristic_run << ","
             << summary.timesRepeatedRouteWasPriced << "," << (summary.repeatedRoutesTotalReducedCost / summary.timesRepeatedRouteWasPriced) << ","
+            << (int) params->labelStorage << ","
+            << params->pricingThreads << ","
+            << params->useVehicleClasses << "," << problemData->NbVehicleClasses() << ","
+            << params->useCompletionBounds << "," << summary.totalLabelsPrunedByBound << ","
+            << params->ngNeighbourhoodSize << "," << SCIPgetDualboundRoot(scip) << "," << solution.cost - SCIPgetDualboundRoot(scip) << ","
+            << summary.total_pricing_early_exits << ","
+            << summary.incrementalPricingCalls << "," << summary.totalLabelsReused << ","
+            << summary.poolRounds << "," << summary.poolColumnsAdded << ","
+            << summary.rootTime << "," << summary.rootPricingTime << "," << summary.rootPricingCalls << "," << summary.mispricings << ","
+            << summary.lagrangianBounds << "," << summary.cgEarlyStops << ","
+            << tierStats.str() << ","
+            << rootGapClosure.str() << ","
             << commit_hash
    << endl;
 
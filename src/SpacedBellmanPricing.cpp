@@ -3,12 +3,15 @@
 
 #include <iterator>
 #include <ctime>
+#include <chrono>
 #include <vector>
 #include <set>
 #include <iostream>
 #include <algorithm>
+#include <unordered_map>
 
-SpacedBellmanPricing::SpacedBellmanPricing(Params *params, ProblemData* problemData) : labels()
+template <template <class> class LabelStore>
+SpacedBellmanPricing<LabelStore>::SpacedBellmanPricing(Params *params, ProblemData* problemData) : labels()
 {
 	this->problemData = problemData;
 	this->params = params;
@@ -18,25 +21,30 @@ SpacedBellmanPricing::SpacedBellmanPricing(Params *params, ProblemData* problemD
 	useRepeatedSetVerification = false;
 
 	heuristicPricing = false;
+	ng = NULL;
 	
 }
 
-bool SpacedBellmanPricing::comp(const PricingLabel& lhs, const PricingLabel& rhs)
+template <template <class> class LabelStore>
+bool SpacedBellmanPricing<LabelStore>::comp(const PricingLabel& lhs, const PricingLabel& rhs)
 {
 	return lhs.reducedCost < rhs.reducedCost;
 }
 
-bool SpacedBellmanPricing::comp2(const PricingLabel* lhs, const PricingLabel* rhs)
+template <template <class> class LabelStore>
+bool SpacedBellmanPricing<LabelStore>::comp2(const PricingLabel* lhs, const PricingLabel* rhs)
 {
 	return lhs->reducedCost > rhs->reducedCost;
 }
 
-bool SpacedBellmanPricing::comp3(const PricingLabel& lhs, const PricingLabel& rhs)
+template <template <class> class LabelStore>
+bool SpacedBellmanPricing<LabelStore>::comp3(const PricingLabel& lhs, const PricingLabel& rhs)
 {
 	return lhs.time < rhs.time;
 }
 
-bool SpacedBellmanPricing::TryAddToBestLabelsHeap(PricingLabel &label)
+template <template <class> class LabelStore>
+bool SpacedBellmanPricing<LabelStore>::TryAddToBestLabelsHeap(PricingLabel &label)
 {
 	bool ret = false;
 	if(label.reducedCost > -params->RCEpsilon) return false;
@@ -64,7 +72,8 @@ bool SpacedBellmanPricing::TryAddToBestLabelsHeap(PricingLabel &label)
 
 }
 
-bool SpacedBellmanPricing::TryAddLabel(PricingLabel& newLabel, int j, bool initial = false)
+template <template <class> class LabelStore>
+bool SpacedBellmanPricing<LabelStore>::TryAddLabel(PricingLabel& newLabel, int j, bool initial)
 {
 	/* suppose that labels[j] is already:
 		- ordered by increasing time
@@ -81,13 +90,12 @@ bool SpacedBellmanPricing::TryAddLabel(PricingLabel& newLabel, int j, bool initi
 
 	if(initial)
 	{
-		labels.push_back(std::multiset <std::unique_ptr<PricingLabel>, decltype(compLTime)*>(compLTime));
+		labels.push_back(LabelContainer(&arena));
 
 
 		bool best = TryAddToBestLabelsHeap(newLabel);
 		//newLabel.lastLabel->referenced = true;
-		unique_ptr label_uptr = std::make_unique<PricingLabel>(newLabel);
-		labels.back().insert(std::move(label_uptr));
+		labels.back().Insert(labels.back().end(), newLabel);
 
 		ItrNextExpansion.push_back(labels.back().begin());
 		ItrNextExpansion_IsValid.push_back(true);
@@ -99,12 +107,12 @@ bool SpacedBellmanPricing::TryAddLabel(PricingLabel& newLabel, int j, bool initi
 		return true;
 	}
 
-	assert(labels[j].begin()->get()->reqId == newLabel.reqId);
+	assert(labels[j].Get(labels[j].begin())->reqId == newLabel.reqId);
 
 	bool added = false;
 
 
-	auto insert_position = std::upper_bound(labels[j].begin(), labels[j].end(), std::make_unique<PricingLabel>(newLabel), compLTime);
+	LabelIterator insert_position = labels[j].UpperBound(newLabel.time);
 	//assert that i'm not inserting before 'fixed labels' position
 
 	//auto prev = std::prev(insert_position);
@@ -120,21 +128,24 @@ bool SpacedBellmanPricing::TryAddLabel(PricingLabel& newLabel, int j, bool initi
 	}
 	else if(insert_position == labels[j].end())
 	{
-		//rbegin points to last element in the set.
-		dominated = newLabel.reducedCost + params->RCEpsilon > (*labels[j].rbegin())->reducedCost;
-		bestRCedLabel = newLabel.reducedCost + params->RCEpsilon < (*labels[j].rbegin())->reducedCost;
+		//prev(end) points to last element in the container.
+		double lastRC = labels[j].ReducedCost(std::prev(labels[j].end()));
+		dominated = newLabel.reducedCost + DominanceEpsilon() > lastRC;
+		if(ng != NULL) dominated = dominated && NgNeighbourhoods::IsSubset(labels[j].Get(std::prev(labels[j].end()))->ngMemory, newLabel.ngMemory);
+		bestRCedLabel = newLabel.reducedCost + DominanceEpsilon() < lastRC;
 	}
 	else if(insert_position == labels[j].begin())
 	{
-		assert(newLabel.time < (*labels[j].begin())->time);
+		assert(newLabel.time < labels[j].Time(labels[j].begin()));
 		dominated = false;
 		bestRCedLabel = false;
 	}
 	else
 	{
-		insert_position--; //lower_bounds points to the first not less than newLabel. I want the label before that so I can compare. edge cases are treated above
-		assert((*insert_position)->time <= newLabel.time); // upper_bound and -- makes us points to exact ties too!
-		dominated = newLabel.reducedCost + params->RCEpsilon > (*insert_position)->reducedCost;
+		LabelIterator prev_position = std::prev(insert_position); //upper_bound points to the first greater than newLabel. I want the label before that so I can compare. edge cases are treated above
+		assert(labels[j].Time(prev_position) <= newLabel.time); // upper_bound and -- makes us points to exact ties too!
+		dominated = newLabel.reducedCost + DominanceEpsilon() > labels[j].ReducedCost(prev_position);
+		if(ng != NULL) dominated = dominated && NgNeighbourhoods::IsSubset(labels[j].Get(prev_position)->ngMemory, newLabel.ngMemory);
 		bestRCedLabel = false;
 	}
 
@@ -157,13 +168,22 @@ bool SpacedBellmanPricing::TryAddLabel(PricingLabel& newLabel, int j, bool initi
 		return false;
 	}
 
+	//labels that improve the best reduced cost of the request are always kept
+	if(!best && !bestRCedLabel && limitNbLabels && labels[j].size() >= (size_t) maxLabels)
+	{
+		return false;
+	}
+
 	//start to actually insert, given that it isn't dominated
 	newLabel.lastLabel->referenced = true; //mark last label as 'referenced' so it isnt deleted
 
-	unique_ptr label_uptr = std::make_unique<PricingLabel>(newLabel);	
-	
+	/*
+		decide if ItrNextExpansion must move *before* inserting: 
+		in the bucket container, inserting shifts the positions after insert_position
+	*/
+	bool moveNextExpansion = !ItrNextExpansion_IsValid[j] || newLabel.time < labels[j].Time(ItrNextExpansion[j]);
 
-	auto just_inserted_itr = labels[j].insert(std::move(label_uptr)); //labels[j] assumes ownership of newLabel
+	LabelIterator just_inserted_itr = labels[j].Insert(insert_position, newLabel); //labels[j] stores a copy of newLabel
 	// if(!ret.second)
 	// {
 	// 	//elements have the same time. But, we already know it isn't dominated
@@ -195,7 +215,7 @@ bool SpacedBellmanPricing::TryAddLabel(PricingLabel& newLabel, int j, bool initi
 
 	*/
 	
-	if(!ItrNextExpansion_IsValid[j] || newLabel.time < (*ItrNextExpansion[j])->time)
+	if(moveNextExpansion)
 	{
 		ItrNextExpansion[j] = just_inserted_itr; //ret.first is an iterator to the just inserted element
 		ItrNextExpansion_IsValid[j] = true;
@@ -203,7 +223,12 @@ bool SpacedBellmanPricing::TryAddLabel(PricingLabel& newLabel, int j, bool initi
 
 	FilterLabels(j, newLabel, just_inserted_itr);
 
-	assert(std::is_sorted(labels[j].begin(), labels[j].end(), compLTime));
+	#ifndef NDEBUG
+	for(LabelIterator itr = labels[j].begin(); itr != labels[j].end() && std::next(itr) != labels[j].end(); itr++)
+	{
+		assert(labels[j].Time(itr) <= labels[j].Time(std::next(itr)));
+	}
+	#endif
 	//assert(std::is_sorted(labels[j].begin(), labels[j].end(), compGRC));
 	
 	return true;
@@ -211,7 +236,8 @@ bool SpacedBellmanPricing::TryAddLabel(PricingLabel& newLabel, int j, bool initi
 
 //assumes the labels are already ordered by best reduced cost!
 //start filtering at starting pos
-void SpacedBellmanPricing::FilterLabels(int index, PricingLabel &just_added, std::multiset <unique_ptr<PricingLabel>, decltype(compLTime)*>::iterator just_added_itr)
+template <template <class> class LabelStore>
+void SpacedBellmanPricing<LabelStore>::FilterLabels(int index, PricingLabel &just_added, LabelIterator /*just_added_itr*/)
 {
 	return;
 	//assert(starting_pos != labels[index].begin());
@@ -228,12 +254,12 @@ void SpacedBellmanPricing::FilterLabels(int index, PricingLabel &just_added, std
 
 	if(heuristicPricing)
 	{
-		double bestRC = (*labels[index].rbegin())->reducedCost;
+		double bestRC = labels[index].ReducedCost(std::prev(labels[index].end()));
 		//remove if label is worse than bestRC
-		auto remove_test_function = [&just_added, &bestRC](const unique_ptr<PricingLabel> &label)
+		auto remove_test_function = [&just_added, &bestRC](const PricingLabel &label)
 		{ 
 			//assert(label.time + RC_EPS > just_added.time);
-			return !label->referenced && label->reducedCost > bestRC;
+			return !label.referenced && label.reducedCost > bestRC;
 		};
 
 		size_t size_before = labels[index].size();
@@ -244,7 +270,7 @@ void SpacedBellmanPricing::FilterLabels(int index, PricingLabel &just_added, std
 		unless I can be confident that just_added_itr is very often in the end of the set, which would make iterating fast
 		either way, have to test
 		*/
-		std::erase_if(labels[index], remove_test_function);
+		labels[index].EraseIf(remove_test_function);
 		
 		//labels[index].erase(std::remove_if(labels[index].begin(), labels[index].end(), remove_test_function), labels[index].end());
 		size_t size_after = labels[index].size();
@@ -261,10 +287,10 @@ void SpacedBellmanPricing::FilterLabels(int index, PricingLabel &just_added, std
 	{
 
 		//remove if label is dominated by just_added
-		auto remove_test_function = [&just_added](const unique_ptr<PricingLabel> &label)
+		auto remove_test_function = [&just_added](const PricingLabel &label)
 		{ 
 			//assert(label.time + RC_EPS > just_added.time);
-			return !label->referenced && label->reducedCost > just_added.reducedCost && label->time > just_added.time; //RC_EPS?
+			return !label.referenced && label.reducedCost > just_added.reducedCost && label.time > just_added.time; //RC_EPS?
 		};
 
 		size_t size_before = labels[index].size();
@@ -275,7 +301,7 @@ void SpacedBellmanPricing::FilterLabels(int index, PricingLabel &just_added, std
 		unless I can be confident that just_added_itr is very often in the end of the set, which would make iterating fast
 		either way, have to test
 		*/
-		std::erase_if(labels[index], remove_test_function);
+		labels[index].EraseIf(remove_test_function);
 		
 		//labels[index].erase(std::remove_if(labels[index].begin(), labels[index].end(), remove_test_function), labels[index].end());
 		size_t size_after = labels[index].size();
@@ -289,52 +315,335 @@ void SpacedBellmanPricing::FilterLabels(int index, PricingLabel &just_added, std
 	}
 }
 
-bool SpacedBellmanPricing::compGTime(const PricingLabel &l1, const PricingLabel &l2)
+template <template <class> class LabelStore>
+bool SpacedBellmanPricing<LabelStore>::compGTime(const PricingLabel &l1, const PricingLabel &l2)
 {
 	return l1.time > l2.time;
 }
 
-bool SpacedBellmanPricing::compGRC(const PricingLabel &l1, const PricingLabel &l2)
+template <template <class> class LabelStore>
+bool SpacedBellmanPricing<LabelStore>::compGRC(const PricingLabel &l1, const PricingLabel &l2)
 {
 	return l1.reducedCost > l2.reducedCost;
 }
 
-bool SpacedBellmanPricing::compLTime(const unique_ptr<PricingLabel> &l1, const unique_ptr<PricingLabel> &l2)
-{
-	return l1->time < l2->time;
-}
-bool SpacedBellmanPricing::compLTimeRef(const PricingLabel &l1, const PricingLabel &l2)
+template <template <class> class LabelStore>
+bool SpacedBellmanPricing<LabelStore>::compLTimeRef(const PricingLabel &l1, const PricingLabel &l2)
 {
 	return l1.time < l2.time;
 }
 
-bool SpacedBellmanPricing::compLRC(const unique_ptr<PricingLabel> &l1, const unique_ptr<PricingLabel> &l2)
-{
-	return l1->reducedCost < l2->reducedCost;
-}
-bool SpacedBellmanPricing::compLRCRef(const PricingLabel &l1, const PricingLabel &l2)
+template <template <class> class LabelStore>
+bool SpacedBellmanPricing<LabelStore>::compLRCRef(const PricingLabel &l1, const PricingLabel &l2)
 {
 	return l1.reducedCost < l2.reducedCost;
 }
 
 
-void SpacedBellmanPricing::Cleanup()
+template <template <class> class LabelStore>
+void SpacedBellmanPricing<LabelStore>::Cleanup()
 {
 	labels.clear();
 
-	//free intermediate positions:
-	for(int i = 0; i < intermediatePositions.size(); i++)
+	// best labels heap does NOT have ownership of labels!
+	bestLabelsHeap.clear();
+
+	//labels and intermediate positions are all in the arena, free them at once (memory is kept for the next call)
+	arena.Reset();
+
+}
+
+template <template <class> class LabelStore>
+void SpacedBellmanPricing<LabelStore>::StoreLabelTree(int vehicle_id, double alpha_dual, const vector<double>& beta_duals, const PricingEdges& edges)
+{
+	if((int) labelTrees.size() < problemData->NbVehicleClasses()) labelTrees.resize(problemData->NbVehicleClasses());
+	LabelTree &tree = labelTrees[problemData->GetVehicleClass(vehicle_id)];
+	tree.nodes.clear();
+	tree.intermediates.clear();
+	tree.nodesOfRequest.clear();
+	tree.byCost.clear();
+	tree.beta_duals = beta_duals;
+	tree.edges = edges;
+	if(total_labels > MaxLabelTreeSize) return;
+
+	//labels are only deleted by FilterLabels, which keeps referenced ones, so every parent is stored too
+	std::unordered_map<const PricingLabel*, int> nodeOf;
+	nodeOf.reserve(total_labels);
+	vector<const PricingLabel*> stored; //parents first
+	vector<vector<int>> children;
+	vector<int> roots;
+	vector<const PricingLabel*> path;
+	for(int i = 0; i < (int) labels.size(); i++)
 	{
-		delete intermediatePositions[i];
+		for(LabelIterator itr = labels[i].begin(); itr != labels[i].end(); itr++)
+		{
+			path.clear();
+			for(const PricingLabel* label = labels[i].Get(itr); label != NULL && nodeOf.count(label) == 0; label = label->lastLabel)
+			{
+				path.push_back(label);
+			}
+			for(auto it = path.rbegin(); it != path.rend(); it++)
+			{
+				const PricingLabel* label = *it;
+				int k = stored.size();
+				nodeOf[label] = k;
+				stored.push_back(label);
+				children.emplace_back();
+				if(label->lastLabel != NULL) children[nodeOf[label->lastLabel]].push_back(k);
+				else roots.push_back(k);
+			}
+		}
 	}
-	intermediatePositions.clear();
 
-	// best labels heap does NOT have ownership of labels!
-	bestLabelsHeap.clear();
+	//preorder, so that the nodes of each subtree are contiguous
+	vector<int> nodeIndex(stored.size());
+	vector<int> stack(roots.rbegin(), roots.rend());
+	while(!stack.empty())
+	{
+		int k = stack.back();
+		stack.pop_back();
+		const PricingLabel* label = stored[k];
+		const Request* req = problemData->GetRequest(label->reqId);
+
+		LabelTreeNode node;
+		node.reqId = label->reqId;
+		node.reqIndex = problemData->RequestIdToIndex(label->reqId);
+		node.parent = label->lastLabel != NULL ? nodeIndex[nodeOf[label->lastLabel]] : -1;
+		node.subtreeEnd = tree.nodes.size() + 1;
+		node.time = label->time;
+		node.lateness = problemData->weighted_lateness(req, label->time);
+		node.cost = label->reducedCost + alpha_dual;
+		node.lastWaitingStation = label->lastWaitingStation;
+		node.intermediate = -1;
+		if(label->intermediatePosition != NULL)
+		{
+			node.intermediate = tree.intermediates.size();
+			tree.intermediates.push_back(*label->intermediatePosition);
+		}
+
+		nodeIndex[k] = tree.nodes.size();
+		tree.nodes.push_back(node);
+		stack.insert(stack.end(), children[k].rbegin(), children[k].rend());
+	}
+
+	//children come after their parents
+	tree.nodesOfRequest.resize(problemData->NbRequests());
+	for(int k = tree.nodes.size() - 1; k >= 0; k--)
+	{
+		const LabelTreeNode &node = tree.nodes[k];
+		if(node.parent != -1) tree.nodes[node.parent].subtreeEnd = std::max(tree.nodes[node.parent].subtreeEnd, node.subtreeEnd);
+		tree.nodesOfRequest[node.reqIndex].push_back(k);
+	}
 
+	tree.byCost.resize(tree.nodes.size());
+	for(int k = 0; k < (int) tree.nodes.size(); k++) tree.byCost[k] = k;
+	std::sort(tree.byCost.begin(), tree.byCost.end(), [&tree](int a, int b) { return tree.nodes[a].cost < tree.nodes[b].cost; });
 }
 
-PricingReturn SpacedBellmanPricing::Price(int vehicle_id, int n_routes, vector<double>& alpha_duals, vector<double>& beta_duals, vector<Route>& outRoutes, vector<int> consideredRequests, set<pair<int, int>> forbiddenEdges, map<pair<int, int>, double> edgeDuals)
+template <template <class> class LabelStore>
+bool SpacedBellmanPricing<LabelStore>::TryIncrementalPricing(int vehicle_id, double alpha_dual, const vector<double>& beta_duals, const vector<int>& consideredRequests, const PricingEdges& edges)
+{
+	int vehicleClass = problemData->GetVehicleClass(vehicle_id);
+	if(vehicleClass >= (int) labelTrees.size() || labelTrees[vehicleClass].nodes.empty()) return false;
+	const LabelTree &tree = labelTrees[vehicleClass];
+	int nbRequests = problemData->NbRequests();
+
+	//requests whose labels cost something else now. Unless they are removed, so do the labels after them
+	vector<bool> changed(nbRequests, true);
+	for(int reqId : consideredRequests) changed[problemData->RequestIdToIndex(reqId)] = false;
+	vector<bool> considered(nbRequests);
+	for(int i = 0; i < nbRequests; i++) considered[i] = !changed[i];
+
+	//too much has changed since the tree was built: the labeling would likely find much better routes
+	int changedDuals = 0;
+	for(int i = 0; i < nbRequests; i++)
+	{
+		if(std::abs(beta_duals[i] - tree.beta_duals[i]) > params->RCEpsilon) changedDuals++;
+	}
+	if(changedDuals > params->incrementalMaxChangedDuals * beta_duals.size()) return false;
+
+	//any change, however small, since costs add up along the routes
+	for(int i = 0; i < nbRequests; i++)
+	{
+		if(beta_duals[i] != tree.beta_duals[i]) changed[i] = true;
+	}
+	for(int i = 0; i < nbRequests; i++)
+	{
+		for(int k = 0; k < nbRequests; k++)
+		{
+			if(changed[k]) continue;
+			if(edges.IsForbidden(i, k) != tree.edges.IsForbidden(i, k) || edges.Dual(i, k) != tree.edges.Dual(i, k)) changed[k] = true;
+		}
+	}
+
+	//subtrees under the changed requests, disjoint and by increasing start
+	vector<int> changedNodes;
+	for(int i = 0; i < nbRequests; i++)
+	{
+		if(changed[i]) changedNodes.insert(changedNodes.end(), tree.nodesOfRequest[i].begin(), tree.nodesOfRequest[i].end());
+	}
+	std::sort(changedNodes.begin(), changedNodes.end());
+	vector<std::pair<int, int>> changedSubtrees;
+	for(int k : changedNodes)
+	{
+		if(!changedSubtrees.empty() && k < changedSubtrees.back().second) continue;
+		changedSubtrees.emplace_back(k, tree.nodes[k].subtreeEnd);
+	}
+	auto isChanged = [&changedSubtrees](int k)
+	{
+		auto itr = std::upper_bound(changedSubtrees.begin(), changedSubtrees.end(), k, [](int k, const std::pair<int, int> &subtree) { return k < subtree.first; });
+		return itr != changedSubtrees.begin() && k < std::prev(itr)->second;
+	};
+
+	//labels only for the nodes that may enter bestLabelsHeap, and their parents
+	std::unordered_map<int, double> changedCost; //re-costed nodes. Missing ones went through a request or an edge no longer allowed
+	std::unordered_map<int, PricingLabel*> nodeLabels;
+	vector<int> path;
+	auto addToBestLabels = [&](int k, double reducedCost)
+	{
+		if(reducedCost > -params->RCEpsilon) return;
+		if(bestLabelsHeap.size() >= n_desired_routes && bestLabelsHeap.front().reducedCost - params->RCEpsilon <= reducedCost) return;
+
+		path.clear();
+		for(int p = k; p != -1 && nodeLabels.count(p) == 0; p = tree.nodes[p].parent) path.push_back(p);
+		for(auto it = path.rbegin(); it != path.rend(); it++)
+		{
+			const LabelTreeNode &node = tree.nodes[*it];
+			auto found = changedCost.find(*it);
+
+			PricingLabel label;
+			label.reqId = node.reqId;
+			label.reducedCost = (found != changedCost.end() ? found->second : node.cost) - alpha_dual;
+			label.time = node.time;
+			label.lastWaitingStation = node.lastWaitingStation;
+			label.intermediatePosition = node.intermediate != -1 ? arena.New(tree.intermediates[node.intermediate]) : NULL;
+			label.ngMemory = 0;
+			label.lastLabel = node.parent != -1 ? nodeLabels[node.parent] : NULL;
+			label.referenced = true;
+			label.alreadyExpanded = true;
+			nodeLabels[*it] = arena.New(label);
+		}
+		TryAddToBestLabelsHeap(*nodeLabels[k]);
+	};
+
+	for(const std::pair<int, int> &subtree : changedSubtrees)
+	{
+		for(int k = subtree.first; k < subtree.second; k++)
+		{
+			const LabelTreeNode &node = tree.nodes[k];
+			if(!considered[node.reqIndex]) continue;
+
+			//the parent of the subtree's root hasn't changed
+			double cost = 0.0;
+			if(node.parent != -1)
+			{
+				if(k == subtree.first) cost = tree.nodes[node.parent].cost;
+				else
+				{
+					auto found = changedCost.find(node.parent);
+					if(found == changedCost.end()) continue;
+					cost = found->second;
+				}
+				int iParentReq = tree.nodes[node.parent].reqIndex;
+				if(edges.IsForbidden(iParentReq, node.reqIndex)) continue;
+				cost -= edges.Dual(iParentReq, node.reqIndex);
+			}
+			cost += node.lateness - beta_duals[node.reqIndex];
+			changedCost[k] = cost;
+
+			pricing_ret.labelsReused++;
+			addToBestLabels(k, cost - alpha_dual);
+		}
+	}
+
+	//the other nodes keep their cost, the best first
+	for(int k : tree.byCost)
+	{
+		double reducedCost = tree.nodes[k].cost - alpha_dual;
+		if(reducedCost > -params->RCEpsilon) break;
+		if(bestLabelsHeap.size() >= n_desired_routes && bestLabelsHeap.front().reducedCost - params->RCEpsilon <= reducedCost) break;
+		if(isChanged(k)) continue;
+
+		pricing_ret.labelsReused++;
+		addToBestLabels(k, reducedCost);
+	}
+
+	if(bestLabelsHeap.empty())
+	{
+		arena.Reset();
+		return false;
+	}
+	return true;
+}
+
+template <template <class> class LabelStore>
+void SpacedBellmanPricing<LabelStore>::BuildRoutes(int vehicle_id, vector<Route>& outRoutes)
+{
+	outRoutes.clear();
+
+	for (int i = 0; i < (int) bestLabelsHeap.size(); i++)
+	{
+		Route route;
+		const PricingLabel* label = &bestLabelsHeap[i];
+
+		//if label->reducedCost is positive or not very negative, dont return it
+		if (label->reducedCost > -params->RCEpsilon) continue;
+
+		double firstLabelRC = label->reducedCost;
+
+		route.veh_index = vehicle_id;
+
+		//first, add it all in reverse:
+		while (true) 
+		{
+			if(label == NULL) break;
+
+			//first, add it all in reverse:
+			const Request* req = problemData->GetRequest(label->reqId);
+			route.vertices.push_back(*req);
+			//outRoutes[i].arrival_times.push_back(label->time);
+
+			assert(!(label->intermediatePosition != NULL && label->lastWaitingStation != -1));
+
+			if(label->intermediatePosition != NULL)
+			{
+				assert(label->intermediatePosition->id == -1);
+				route.intermediates.push_back(*label->intermediatePosition);
+				route.vertices.push_back((Vertex) *label->intermediatePosition);
+			}
+			if (label->lastWaitingStation != -1) { //if this transition stops at a waiting station...
+				const WaitingStation* ws = problemData->GetWaitingStation(label->lastWaitingStation);
+				route.vertices.push_back(*ws); //add waiting station
+			}
+
+			//get next label:
+
+			assert(label->lastLabel == NULL || label->lastLabel->referenced);
+			label = label->lastLabel;
+		
+		}
+		
+		//insert source vertex
+		route.vertices.push_back(*problemData->GetInitialPosition(vehicle_id));
+		route.veh_index = vehicle_id;
+
+		//reverse entire route
+		std::reverse(route.vertices.begin(), route.vertices.end());
+		std::reverse(route.intermediates.begin(), route.intermediates.end());
+
+
+		//tratar corretamente desvios nessas funcoes auxiliares
+		route.SetArrivalsAndDepartures(problemData);
+
+		route.UpdateCost(problemData);
+		outRoutes.push_back(route);
+		pricing_ret.reducedCostPerRoute.push_back(firstLabelRC);
+		
+	}
+}
+
+template <template <class> class LabelStore>
+PricingReturn SpacedBellmanPricing<LabelStore>::Price(int vehicle_id, int n_routes, vector<double>& alpha_duals, vector<double>& beta_duals, vector<Route>& outRoutes, vector<int> consideredRequests, const PricingEdges& edges)
 {
 	assert(alpha_duals.size() == problemData->NbVehicles());
 	assert(beta_duals.size() == problemData->NbRequests());
@@ -350,9 +659,13 @@ PricingReturn SpacedBellmanPricing::Price(int vehicle_id, int n_routes, vector<d
 	assert(consideredRequests.size() > 0);
 
 	RouteExpander routeExpander(params);
+	const TransitionTable* transitionTable = problemData->GetTransitionTable(); //may be NULL
+	ng = problemData->GetNgNeighbourhoods(); //may be NULL
 
-	std::clock_t alg_start = std::clock();
+	//wall clock: std::clock would also count other threads pricing at the same time
+	auto alg_start = std::chrono::steady_clock::now();
 	bool timeout = false;
+	bool exitedEarly = false;
 
 	pricing_ret = PricingReturn();
 	pricing_ret.nbConsideredRequests = consideredRequests.size();
@@ -369,10 +682,20 @@ PricingReturn SpacedBellmanPricing::Price(int vehicle_id, int n_routes, vector<d
 	ItrNextExpansion.clear();
 	ItrNextExpansion_IsValid.clear();
 
-	//annoying manual memory allocation, but not too crazy
-	//vector<IntermediateVertex*> intermediatePositions;
-	
-	labels = vector<std::multiset <unique_ptr<PricingLabel>, decltype(compLTime)*> >();
+	//containers must be gone before the arena they allocate from is reset
+	labels = vector<LabelContainer>();
+	arena.Reset();
+	labels.reserve(consideredRequests.size());
+
+	//the labels of the previous call may still hold good enough routes
+	if(params->useIncrementalPricing && !exactReducedCosts && TryIncrementalPricing(vehicle_id, alpha_duals[vehicle_id], beta_duals, consideredRequests, edges))
+	{
+		pricing_ret.incremental = true;
+		BuildRoutes(vehicle_id, outRoutes);
+		Cleanup();
+		pricing_ret.status = PricingReturnStatus::OK;
+		return pricing_ret;
+	}
 	
 	for (int i = 0; i < consideredRequests.size(); i++)
 	{
@@ -401,15 +724,14 @@ PricingReturn SpacedBellmanPricing::Price(int vehicle_id, int n_routes, vector<d
 		if(useIntermediate)
 		{
 			label.lastWaitingStation = -1;
-			IntermediateVertex *ptr = new IntermediateVertex(intermediateVertex);
-			intermediatePositions.push_back(ptr);
-			label.intermediatePosition = ptr;
+			label.intermediatePosition = arena.New(intermediateVertex);
 		}
 		else
 		{
 			label.lastWaitingStation = waitingStation;
 			label.intermediatePosition = NULL;
 		}
+		label.ngMemory = ng != NULL ? NgNeighbourhoods::Initial() : 0;
 		
 		label.alreadyExpanded = false;
 		
@@ -433,7 +755,7 @@ PricingReturn SpacedBellmanPricing::Price(int vehicle_id, int n_routes, vector<d
 	{
 		assert(ItrNextExpansion_IsValid[i]);
 		assert(labels[i].begin() == ItrNextExpansion[i]);
-		new_consideredRequests.push_back((*labels[i].begin())->reqId);
+		new_consideredRequests.push_back(labels[i].Get(labels[i].begin())->reqId);
 	}
 	consideredRequests = new_consideredRequests;
 
@@ -446,6 +768,13 @@ PricingReturn SpacedBellmanPricing::Price(int vehicle_id, int n_routes, vector<d
 		
 	assert(labels.size() == consideredRequests.size());
 
+	/*
+		the greedy heuristic expands a single label per request, so building the bound would cost more than the labeling it saves.
+		Label-limited tiers do build it: pruned labels would otherwise take the slots of promising ones
+	*/
+	if(params->useCompletionBounds && !heuristicPricing && !exactReducedCosts) completionBound.Build(problemData, vehicle_id, consideredRequests, beta_duals, edges, params->completionBoundBuckets);
+	else completionBound.Clear();
+
 	/*
 	since the vectors are ordered by increasing time, there is a certain position before which:
 		- all labels have been expanded
@@ -457,23 +786,24 @@ PricingReturn SpacedBellmanPricing::Price(int vehicle_id, int n_routes, vector<d
 	//bellman-ford like
 	int iteration = 0;
 	bool anySuccess = true;
-	while (anySuccess && !timeout)
+	while (anySuccess && !timeout && !exitedEarly)
 	{
 		anySuccess = false;
-		for(int i = 0; i < consideredRequests.size() && !timeout; i++)
+		for(int i = 0; i < (int) consideredRequests.size() && !timeout && !exitedEarly; i++)
 		{
 			const Request* req = problemData->GetRequest(consideredRequests[i]);
+			int iReq = problemData->RequestIdToIndex(req->id);
 			int iLabel;
 
 			if(labels[i].size() == 0) continue;
 			if(!ItrNextExpansion_IsValid[i]) continue;
 
-			for(	auto itr = heuristicPricing ? --labels[i].end() : ItrNextExpansion[i];
-					itr != labels[i].end() && !timeout; 
+			for(	LabelIterator itr = heuristicPricing ? std::prev(labels[i].end()) : ItrNextExpansion[i];
+					itr != labels[i].end() && !timeout && !exitedEarly; 
 					itr++
 			)
 			{
-				const PricingLabel* label = itr->get();
+				const PricingLabel* label = labels[i].Get(itr);
 				assert(req->id == label->reqId);
 				assert(labels[i].size() > 0);
 
@@ -483,18 +813,17 @@ PricingReturn SpacedBellmanPricing::Price(int vehicle_id, int n_routes, vector<d
 				{
 					//try expading from i to j
 					const Request* nextReq = problemData->GetRequest(consideredRequests[j]);
-					assert(labels[j].size() == 0 || nextReq->id == (*labels[j].begin())->reqId);
+					assert(labels[j].size() == 0 || nextReq->id == labels[j].Get(labels[j].begin())->reqId);
 
 					if(req->id == nextReq->id) continue;
 
+					int iNextReq = problemData->RequestIdToIndex(nextReq->id);
+
 					//if branching rule forbids this request-to-request connection, skip it
-					pair<int, int> pair1 = std::make_pair(req->id, nextReq->id);
-					pair<int, int> pair2 = std::make_pair(nextReq->id, req->id);
+					if(edges.IsForbidden(iReq, iNextReq)) continue;
 
-					if(forbiddenEdges.find(pair1) != forbiddenEdges.end() || forbiddenEdges.find(pair2) != forbiddenEdges.end()) continue;
-					
-					
-					int iNextReq = problemData->RequestIdToIndex(nextReq->id);
+					//ng-route relaxation: the route still remembers visiting nextReq
+					if(ng != NULL && ng->Forbids(label->ngMemory, iReq, iNextReq)) continue;
 
 					//manually checking for cycles! 
 					//if !useRepeatedSetVerification, check is skipped
@@ -506,15 +835,15 @@ PricingReturn SpacedBellmanPricing::Price(int vehicle_id, int n_routes, vector<d
 					int waitingStation = -1;
 					bool useIntermediate = false;
 					IntermediateVertex intermediateVertex = IntermediateVertex();
-					bool ret = routeExpander.checkRouteExpansion(problemData, vehicle_id, nextReq, req, label->time, newTime, waitingStation, useIntermediate, intermediateVertex);
+					bool ret = routeExpander.checkRequestExpansion(problemData, transitionTable, vehicle_id, nextReq, iNextReq, req, iReq, label->time, newTime, waitingStation, useIntermediate, intermediateVertex);
 					pricing_ret.labelsPriced++;
 
-					//if we've priced enough labels to exceed 95% of max_memory,
-					if((((double)total_labels * sizeof(PricingLabel)) / 1000000) > (double) max_memory * 0.95)
+					//if the arena (labels, intermediate positions and container nodes) exceeds 95% of max_memory,
+					if(((double)arena.BytesUsed() / 1000000) > (double) max_memory * 0.95)
 					{
 						//abort
 						//to-do: maybe clean up and continue?
-						std::cout << "memory out (" << total_labels << " labels)" << std::endl;
+						std::cout << "memory out (" << total_labels << " labels, " << arena.BytesUsed() / 1000000 << " MB)" << std::endl;
 						timeout = true;
 						break;
 					}
@@ -527,14 +856,13 @@ PricingReturn SpacedBellmanPricing::Price(int vehicle_id, int n_routes, vector<d
 					double newReducedCost = label->reducedCost + lateness - beta_duals[iNextReq];
 
 					//add edge duals:
-					int a = std::min(req->id, nextReq->id);
-					int b = std::max(req->id, nextReq->id);
-					assert(a != b);
-					
-					std::pair edge = std::make_pair(a, b);
-					if(edgeDuals.contains(edge))
+					newReducedCost = newReducedCost - edges.Dual(iReq, iNextReq);
+
+					//the rest of the route can't bring it below zero. Also valid under ng-routes, see CompletionBound
+					if(newReducedCost + completionBound.Get(j, newTime) > -params->RCEpsilon)
 					{
-						newReducedCost = newReducedCost - edgeDuals[edge];
+						pricing_ret.labelsPrunedByBound++;
+						continue;
 					}
 					//double newLateness = label->total_lateness + lateness;
 
@@ -546,15 +874,14 @@ PricingReturn SpacedBellmanPricing::Price(int vehicle_id, int n_routes, vector<d
 					if(useIntermediate)
 					{
 						newLabel.lastWaitingStation = -1;
-						IntermediateVertex *ptr = new IntermediateVertex(intermediateVertex);
-						intermediatePositions.push_back(ptr);
-						newLabel.intermediatePosition = ptr;
+						newLabel.intermediatePosition = arena.New(intermediateVertex);
 					}
 					else
 					{
 						newLabel.lastWaitingStation = waitingStation;
 						newLabel.intermediatePosition = NULL;
 					}
+					newLabel.ngMemory = ng != NULL ? ng->Extend(label->ngMemory, iReq, iNextReq) : 0;
 					
 					newLabel.alreadyExpanded = false;
 					
@@ -576,10 +903,16 @@ PricingReturn SpacedBellmanPricing::Price(int vehicle_id, int n_routes, vector<d
 					
 					anySuccess = anySuccess || ret2;
 
+					//enough columns, and all of them good enough
+					if(ret2 && bestLabelsHeap.size() >= n_desired_routes && bestLabelsHeap.front().reducedCost < earlyExitReducedCost)
+					{
+						exitedEarly = true;
+						break;
+					}
+
 					if(pricing_ret.labelsPriced % 1000 == 0)
 					{
-						std::clock_t alg_now = std::clock();
-						double time = ((double)(alg_now - alg_start)) / CLOCKS_PER_SEC;
+						double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - alg_start).count();
 						if(time > max_time || params->Timeout())
 						{
 							timeout = true;
@@ -592,7 +925,7 @@ PricingReturn SpacedBellmanPricing::Price(int vehicle_id, int n_routes, vector<d
 				
 			}
 			
-			ItrNextExpansion[i] = labels[i].end(); //unfortunatelly .end() may move when we add elements to the set, so testing for end later won't work. Thus we need a bool to tell if the iterator is valid!
+			ItrNextExpansion[i] = labels[i].end(); //unfortunatelly .end() may move when we add elements to the container, so testing for end later won't work. Thus we need a bool to tell if the iterator is valid!
 			ItrNextExpansion_IsValid[i] = false;
 		
 		}
@@ -602,13 +935,13 @@ PricingReturn SpacedBellmanPricing::Price(int vehicle_id, int n_routes, vector<d
 
 	//assert all labels have been expanded
 	#ifndef NDEBUG
-		if(!heuristicPricing && !timeout)
+		if(!heuristicPricing && !timeout && !exitedEarly)
 		{
 			for(int i = 0; i < labels.size(); i++)
 			{
-				for(auto &label : labels[i])
+				for(LabelIterator itr = labels[i].begin(); itr != labels[i].end(); itr++)
 				{
-					assert(label->alreadyExpanded);
+					assert(labels[i].Get(itr)->alreadyExpanded);
 				}
 			}
 		}
@@ -616,6 +949,8 @@ PricingReturn SpacedBellmanPricing::Price(int vehicle_id, int n_routes, vector<d
 
 	pricing_ret.mostLabelsInRequest = 0;
 
+	if(params->useIncrementalPricing && !timeout) StoreLabelTree(vehicle_id, alpha_duals[vehicle_id], beta_duals, edges);
+
 	if(bestLabelsHeap.size() == 0)
 	{
 		//no routes found with RC < 0
@@ -624,71 +959,10 @@ PricingReturn SpacedBellmanPricing::Price(int vehicle_id, int n_routes, vector<d
 		return pricing_ret;
 	}
 
-	outRoutes.clear();
-
 	pricing_ret.timeout = timeout;
+	pricing_ret.exitedEarly = exitedEarly;
 
-	double bestRC = HUGE_VAL;
-	int i = 0;
-	for (int i = 0; i < bestLabelsHeap.size(); i++)
-	{
-		Route route;
-		const PricingLabel* label = &bestLabelsHeap[i];
-
-		//if label->reducedCost is positive or not very negative, dont return it
-		if (label->reducedCost > -params->RCEpsilon) continue;
-
-		double firstLabelRC = label->reducedCost;
-
-		route.veh_index = vehicle_id;
-
-		//first, add it all in reverse:
-		while (true) 
-		{
-			if(label == NULL) break;
-
-			//first, add it all in reverse:
-			const Request* req = problemData->GetRequest(label->reqId);
-			route.vertices.push_back(*req);
-			//outRoutes[i].arrival_times.push_back(label->time);
-
-			assert(!(label->intermediatePosition != NULL && label->lastWaitingStation != -1));
-
-			if(label->intermediatePosition != NULL)
-			{
-				assert(label->intermediatePosition->id == -1);
-				route.intermediates.push_back(*label->intermediatePosition);
-				route.vertices.push_back((Vertex) *label->intermediatePosition);
-			}
-			if (label->lastWaitingStation != -1) { //if this transition stops at a waiting station...
-				const WaitingStation* ws = problemData->GetWaitingStation(label->lastWaitingStation);
-				route.vertices.push_back(*ws); //add waiting station
-			}
-
-			//get next label:
-
-			assert(label->lastLabel == NULL || label->lastLabel->referenced);
-			label = label->lastLabel;
-		
-		}
-		
-		//insert source vertex
-		route.vertices.push_back(*problemData->GetInitialPosition(vehicle_id));
-		route.veh_index = vehicle_id;
-
-		//reverse entire route
-		std::reverse(route.vertices.begin(), route.vertices.end());
-		std::reverse(route.intermediates.begin(), route.intermediates.end());
-
-
-		//tratar corretamente desvios nessas funcoes auxiliares
-		route.SetArrivalsAndDepartures(problemData);
-
-		route.UpdateCost(problemData);
-		outRoutes.push_back(route);
-		pricing_ret.reducedCostPerRoute.push_back(firstLabelRC);
-		
-	}
+	BuildRoutes(vehicle_id, outRoutes);
 
 	#ifndef NDEBUG
 	//before returning, check if pricing found repeated routes
@@ -711,3 +985,5 @@ PricingReturn SpacedBellmanPricing::Price(int vehicle_id, int n_routes, vector<d
 
 }
 
+template class SpacedBellmanPricing<MultisetLabelStore>;
+template class SpacedBellmanPricing<BucketLabelStore>;
@@ -0,0 +1,133 @@
+#include "StaticInfrastructure.h"
+
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <cstdint>
+#include <sys/stat.h>
+
+#include "GeodesicKernel.h"
+
+//(lat, long) lines until "END" or the end of the file
+static vector<Position> ReadPositions(std::ifstream &infile, bool stopAtBadLine)
+{
+	vector<Position> positions;
+	std::string line;
+	double posx, posy;
+	while (std::getline(infile, line))
+	{
+		if(line == "END") break;
+		std::istringstream iss(line);
+		//(lat, long) order -> (posy, posx)
+		if (!(iss >> posy >> posx)) {
+			if(stopAtBadLine) break;
+			throw std::invalid_argument("unexpected file format");
+		}
+
+		Position pos; pos.x = posx; pos.y = posy;
+		positions.push_back(pos);
+	}
+	return positions;
+}
+
+StaticInfrastructure StaticInfrastructure::Read(string basesPath, string hospitalsPath, string cleaningBasesPath, DistanceType distanceType)
+{
+	StaticInfrastructure out;
+	out.distanceType = distanceType;
+
+	{
+		std::ifstream infile(basesPath);
+		if (!infile.good()) throw std::invalid_argument("file " + basesPath + " not found");
+		out.bases = ReadPositions(infile, false);
+	}
+
+	{
+		std::ifstream infile(hospitalsPath);
+		if (!infile.good()) throw std::invalid_argument("file " + hospitalsPath + " not found");
+		out.hospitals = ReadPositions(infile, false);
+	}
+
+	{
+		std::ifstream infile(cleaningBasesPath);
+		if (!infile.good()) throw std::invalid_argument("file " + cleaningBasesPath + " not found");
+
+		//first line is nb of stations:
+		std::string line;
+		std::getline(infile, line);
+		int nbCleaning;
+		std::istringstream iss(line);
+		if (!(iss >> nbCleaning)) {
+			throw std::invalid_argument("unexpected file format: " + cleaningBasesPath);
+		}
+
+		out.cleaningBases = ReadPositions(infile, true);
+		if(nbCleaning != (int) out.cleaningBases.size())
+			throw std::invalid_argument("unexpected file format: " + cleaningBasesPath);
+	}
+
+	out.CalculateDistances();
+	return out;
+}
+
+void StaticInfrastructure::CalculateDistances()
+{
+	vector<Position> sites;
+	sites.reserve(NbSites());
+	sites.insert(sites.end(), bases.begin(), bases.end());
+	sites.insert(sites.end(), hospitals.begin(), hospitals.end());
+	sites.insert(sites.end(), cleaningBases.begin(), cleaningBases.end());
+
+	//same calculations as ProblemData::CalculateDistances, so that instances get the same distances as when calculating them themselves
+	toBases.resize((size_t) NbSites() * NbBases());
+	if(distanceType == DistanceType::geodesic)
+	{
+		GeodesicKernel kernel(sites, ProblemData::VehicleSpeed());
+		for(int s = 0; s < NbSites(); s++) kernel.Row(s, 0, NbBases(), toBases.data() + (size_t) s * NbBases());
+	}
+	else
+	{
+		for(int s = 0; s < NbSites(); s++)
+		{
+			for(int b = 0; b < NbBases(); b++) toBases[(size_t) s * NbBases() + b] = s == b ? 0.0 : ProblemData::calculateDistance(sites[s], bases[b], distanceType);
+		}
+	}
+
+	//part of a request's distance to its destination, see ProblemData::readVincentInstance
+	hospitalsToCleaningBases.resize((size_t) NbHospitals() * NbCleaningBases());
+	for(int h = 0; h < NbHospitals(); h++)
+	{
+		for(int c = 0; c < NbCleaningBases(); c++)
+		{
+			hospitalsToCleaningBases[(size_t) h * NbCleaningBases() + c] = ProblemData::calculateDistance(hospitals[h], cleaningBases[c], distanceType);
+		}
+	}
+}
+
+//size and modification time of a file, as CallFile::Open checks them. All -1 if it can't be stat'ed
+static std::tuple<int64_t, int64_t, int64_t> FileStamp(const string &path)
+{
+	struct stat st;
+	if(stat(path.c_str(), &st) != 0) return std::make_tuple(-1, -1, -1);
+	return std::make_tuple((int64_t) st.st_size, (int64_t) st.st_mtim.tv_sec, (int64_t) st.st_mtim.tv_nsec);
+}
+
+std::shared_ptr<const StaticInfrastructure> StaticInfrastructure::Get(string basesPath, string hospitalsPath, string cleaningBasesPath, DistanceType distanceType)
+{
+	typedef std::tuple<string, string, string, DistanceType> Key;
+	typedef vector<std::tuple<int64_t, int64_t, int64_t>> Stamps;
+	static std::mutex mutex;
+	static std::map<Key, std::pair<Stamps, std::shared_ptr<const StaticInfrastructure>>> infrastructures;
+
+	Key key(basesPath, hospitalsPath, cleaningBasesPath, distanceType);
+	//taken before reading, so that files changed while being read are read again next time
+	Stamps stamps = {FileStamp(basesPath), FileStamp(hospitalsPath), FileStamp(cleaningBasesPath)};
+	std::lock_guard<std::mutex> lock(mutex);
+	auto found = infrastructures.find(key);
+	if(found != infrastructures.end() && found->second.first == stamps) return found->second.second;
+
+	std::shared_ptr<const StaticInfrastructure> infrastructure = std::make_shared<const StaticInfrastructure>(Read(basesPath, hospitalsPath, cleaningBasesPath, distanceType));
+	infrastructures[key] = std::make_pair(stamps, infrastructure);
+	return infrastructure;
+}
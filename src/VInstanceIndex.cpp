@@ -0,0 +1,191 @@
+#include "VInstanceIndex.h"
+
+#include <iostream>
+#include <vector>
+#include <cassert>
+
+#include <boost/filesystem.hpp>
+
+namespace fs = boost::filesystem;
+
+bool FindVInstanceByIndex(string dirPath, int instance_index, string osmPath, ProblemData &problemData,  string timeHorizonUsage, double timeHorizon, int setNbVehicles)
+{
+   fs::path dir (dirPath);
+   
+   std::vector<fs::path> paths; std::vector<bool> tenColumns; std::vector<std::string> prefixes; std::vector<bool> OSM_able;
+   std::vector<fs::path> hosp_paths;
+   std::vector<fs::path> ws_paths;
+   std::vector<int> n_entries; //number of entries in input file
+   std::vector<double> default_THs;
+
+   fs::path cleaning_path = dir / "cleaning.txt";
+
+   paths.push_back(dir / "Queues_Of_Calls/simualtedQueues.txt"); tenColumns.push_back(false);
+   prefixes.push_back("queues_"); n_entries.push_back(500); OSM_able.push_back(true); default_THs.push_back(7200);
+   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
+
+   paths.push_back(dir / "Real_Data_Continuous_Scenarios/scenarios_corrected.txt"); tenColumns.push_back(false);
+   prefixes.push_back("realDataContinuous_"); n_entries.push_back(500); OSM_able.push_back(true); default_THs.push_back(7200);
+   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
+
+   paths.push_back(dir / "Simulated_Data_Continuous_Scenarios/Closest_Hospital/scenarios_corrected_40.txt"); tenColumns.push_back(false);
+   prefixes.push_back("simulatedDataClosestHospital_");  n_entries.push_back(500); OSM_able.push_back(true); default_THs.push_back(7200);
+   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
+   
+   paths.push_back(dir / "Simulated_Data_Continuous_Scenarios/Closest_Hospital/scenarios_corrected_200.txt"); tenColumns.push_back(false);
+   prefixes.push_back("simulatedDataClosestHospital_"); n_entries.push_back(500); OSM_able.push_back(true); default_THs.push_back(7200);
+   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
+   
+   paths.push_back(dir / "Simulated_Data_Continuous_Scenarios/Closest_Hospital/scenarios_corrected_600.txt"); tenColumns.push_back(false);
+   prefixes.push_back("simulatedDataClosestHospital_"); n_entries.push_back(500); OSM_able.push_back(true); default_THs.push_back(7200);
+   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
+
+   paths.push_back(dir / "Simulated_Data_Continuous_Scenarios/Random_Hospital/scenarios_corrected_40.txt"); tenColumns.push_back(false);
+   prefixes.push_back("simulatedDataRandomHospital_"); n_entries.push_back(500); OSM_able.push_back(true); default_THs.push_back(7200);
+   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
+   
+   paths.push_back(dir / "Simulated_Data_Continuous_Scenarios/Random_Hospital/scenarios_corrected_200.txt"); tenColumns.push_back(false);
+   prefixes.push_back("simulatedDataRandomHospital_"); n_entries.push_back(500); OSM_able.push_back(true); default_THs.push_back(7200);
+   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
+
+   paths.push_back(dir / "Simulated_Data_Continuous_Scenarios/Random_Hospital/scenarios_corrected_600.txt"); tenColumns.push_back(false);
+   prefixes.push_back("simulatedDataRandomHospital_"); n_entries.push_back(500); OSM_able.push_back(true); default_THs.push_back(7200);
+   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
+
+   paths.push_back(dir / "Simulated_Data_Rectangle/simualtedRectanglePoisson.txt"); tenColumns.push_back(true);
+   prefixes.push_back("rectanglePoisson_"); n_entries.push_back(500); OSM_able.push_back(false); default_THs.push_back(7200);
+   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
+
+   paths.push_back(dir / "Simulated_Data_Rectangle/simualtedRectangleUniform.txt"); tenColumns.push_back(true);
+   prefixes.push_back("rectangleUniform_"); n_entries.push_back(500); OSM_able.push_back(false); default_THs.push_back(7200);
+   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
+
+
+
+   // ---------
+   //instances requested by Thibaut ocupy indices 5000 - 5129:
+
+   //t2:
+   paths.push_back(dir / "Andre/scenarios_n10_t2_r11.txt"); tenColumns.push_back(false);
+   prefixes.push_back("RJ_t2_r11"); n_entries.push_back(10); OSM_able.push_back(true);
+   default_THs.push_back(2*3600);
+   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases11.txt");
+
+   paths.push_back(dir / "Andre/scenarios_n10_t2_r38.txt"); tenColumns.push_back(false);
+   prefixes.push_back("RJ_t2_r38"); n_entries.push_back(10); OSM_able.push_back(true);
+   default_THs.push_back(2*3600);
+   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases38.txt");
+
+   paths.push_back(dir / "Andre/scenarios_n10_t2_r76.txt"); tenColumns.push_back(false);
+   prefixes.push_back("RJ_t2_r76"); n_entries.push_back(10); OSM_able.push_back(true);
+   default_THs.push_back(2*3600);
+   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
+
+   //t4:
+   paths.push_back(dir / "Andre/scenarios_n10_t4_r11.txt"); tenColumns.push_back(false);
+   prefixes.push_back("RJ_t4_r11"); n_entries.push_back(10); OSM_able.push_back(true);
+   default_THs.push_back(4*3600);
+   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases11.txt");
+
+   paths.push_back(dir / "Andre/scenarios_n10_t4_r38.txt"); tenColumns.push_back(false);
+   prefixes.push_back("RJ_t4_r38"); n_entries.push_back(10); OSM_able.push_back(true);
+   default_THs.push_back(4*3600);
+   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases38.txt");
+
+   paths.push_back(dir / "Andre/scenarios_n10_t4_r76.txt"); tenColumns.push_back(false);
+   prefixes.push_back("RJ_t4_r76"); n_entries.push_back(10); OSM_able.push_back(true);
+   default_THs.push_back(4*3600);
+   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
+
+   //t6:
+   paths.push_back(dir / "Andre/scenarios_n10_t6_r11.txt"); tenColumns.push_back(false);
+   prefixes.push_back("RJ_t6_r11"); n_entries.push_back(10); OSM_able.push_back(true);
+   default_THs.push_back(6*3600);
+   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases11.txt");
+
+   paths.push_back(dir / "Andre/scenarios_n10_t6_r38.txt"); tenColumns.push_back(false);
+   prefixes.push_back("RJ_t6_r38"); n_entries.push_back(10); OSM_able.push_back(true);
+   default_THs.push_back(6*3600);
+   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases38.txt");
+
+   paths.push_back(dir / "Andre/scenarios_n10_t6_r76.txt"); tenColumns.push_back(false); //5080
+   prefixes.push_back("RJ_t6_r76"); n_entries.push_back(10); OSM_able.push_back(true);
+   default_THs.push_back(6*3600);
+   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
+
+   //t8:
+   paths.push_back(dir / "Andre/scenarios_n10_t8_r11.txt"); tenColumns.push_back(false);
+   prefixes.push_back("RJ_t8_r11"); n_entries.push_back(10); OSM_able.push_back(true);
+   default_THs.push_back(8*3600);
+   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases11.txt");
+
+   paths.push_back(dir / "Andre/scenarios_n10_t8_r38.txt"); tenColumns.push_back(false);
+   prefixes.push_back("RJ_t8_r38"); n_entries.push_back(10); OSM_able.push_back(true);
+   default_THs.push_back(8*3600);
+   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases38.txt");
+
+   paths.push_back(dir / "Andre/scenarios_n10_t8_r76.txt"); tenColumns.push_back(false);
+   prefixes.push_back("RJ_t8_r76"); n_entries.push_back(10); OSM_able.push_back(true);
+   default_THs.push_back(8*3600);
+   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
+
+   assert(paths.size() == hosp_paths.size() && hosp_paths.size() == ws_paths.size());
+
+   int i_file = 0;
+   int i_position = 0;
+   int i_total = 0;
+   while(i_total <= instance_index && i_file < (int) n_entries.size())
+   {
+      if(i_total + n_entries[i_file] <= instance_index) //next file
+      {
+         i_total += n_entries[i_file];
+         i_file++;
+      }
+      else 
+      {
+         i_position = instance_index - i_total;
+      
+         bool useTimeHorizon = false;
+         double THValue = 0.0;
+         if(timeHorizonUsage == "" || timeHorizonUsage == "default")
+         {
+            useTimeHorizon = true;
+            THValue = default_THs[i_file];
+         }
+         else if(timeHorizonUsage == "value")
+         {
+            useTimeHorizon = true;
+            THValue = timeHorizon;
+         }
+         else if(timeHorizonUsage == "infinite")
+         {
+            useTimeHorizon = false;
+            THValue = 0.0;
+         }
+         else if(timeHorizonUsage == "compute")
+         {
+            //set to default, will be overwritten during execution
+            useTimeHorizon = true;
+            THValue = default_THs[i_file];
+         }
+         else
+         {
+            throw std::invalid_argument("Invalid timeHorizonUsage argument.");
+         }
+
+
+         bool ret = ProblemData::readVincentInstance(paths[i_file].string(), hosp_paths[i_file].string(), ws_paths[i_file].string(), cleaning_path.string(), i_position, problemData, tenColumns[i_file], OSM_able[i_file] ? osmPath : "", useTimeHorizon, THValue, setNbVehicles);
+         if(ret)
+         {
+            problemData.name = prefixes[i_file] + problemData.name;
+            return true;
+         }
+         return false;
+      }
+   }
+
+   throw std::invalid_argument("V instance of id  " + std::to_string(instance_index) + " not found");
+   return false;
+
+
+}
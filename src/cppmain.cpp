@@ -22,6 +22,8 @@
 #include "ProblemSolution.h"
 #include "Params.h"
 #include "SCIPSolver.h"
+#include "NgNeighbourhoods.h"
+#include "VInstanceIndex.h"
 
 namespace fs = boost::filesystem;
 namespace po = boost::program_options;
@@ -31,204 +33,26 @@ using std::endl;
 using std::string;
 
 
-
-//supposes the correct directory structure in this path
-// instance_index: valid range [0, 5039]
-
 /*
-   about timeHorizonUsage:
-   timeHorizonUsage == "" || "default" --> use predetermined default value per instance type
-   timeHorizonUsage == "infinite" --> consider "infinite" time horizon, all requests must be serviced
-   timeHorizonUsage == "value" --> use value of timeHorizon param
+   compiled instances keep the number of vehicles and the time horizon they were converted with (see InstanceConverter).
+   Throws std::invalid_argument if set_nb_vehicles asks for another number of vehicles, and warns that the time horizon options are ignored
 */
-bool FindVInstanceByIndex(string dirPath, int instance_index, string osmPath, ProblemData &problemData,  string timeHorizonUsage, double timeHorizon, int setNbVehicles)
+void CheckCompiledInstanceOptions(const ProblemData &problemData, int setNbVehicles, string timeHorizonUsage, bool hasTimeHorizon)
 {
-   fs::path dir (dirPath);
-   
-   std::vector<fs::path> paths; std::vector<bool> tenColumns; std::vector<std::string> prefixes; std::vector<bool> OSM_able;
-   std::vector<fs::path> hosp_paths;
-   std::vector<fs::path> ws_paths;
-   std::vector<int> n_entries; //number of entries in input file
-   std::vector<double> default_THs;
-
-   fs::path cleaning_path = dir / "cleaning.txt";
-
-   paths.push_back(dir / "Queues_Of_Calls/simualtedQueues.txt"); tenColumns.push_back(false);
-   prefixes.push_back("queues_"); n_entries.push_back(500); OSM_able.push_back(true); default_THs.push_back(7200);
-   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
-
-   paths.push_back(dir / "Real_Data_Continuous_Scenarios/scenarios_corrected.txt"); tenColumns.push_back(false);
-   prefixes.push_back("realDataContinuous_"); n_entries.push_back(500); OSM_able.push_back(true); default_THs.push_back(7200);
-   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
-
-   paths.push_back(dir / "Simulated_Data_Continuous_Scenarios/Closest_Hospital/scenarios_corrected_40.txt"); tenColumns.push_back(false);
-   prefixes.push_back("simulatedDataClosestHospital_");  n_entries.push_back(500); OSM_able.push_back(true); default_THs.push_back(7200);
-   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
-   
-   paths.push_back(dir / "Simulated_Data_Continuous_Scenarios/Closest_Hospital/scenarios_corrected_200.txt"); tenColumns.push_back(false);
-   prefixes.push_back("simulatedDataClosestHospital_"); n_entries.push_back(500); OSM_able.push_back(true); default_THs.push_back(7200);
-   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
-   
-   paths.push_back(dir / "Simulated_Data_Continuous_Scenarios/Closest_Hospital/scenarios_corrected_600.txt"); tenColumns.push_back(false);
-   prefixes.push_back("simulatedDataClosestHospital_"); n_entries.push_back(500); OSM_able.push_back(true); default_THs.push_back(7200);
-   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
-
-   paths.push_back(dir / "Simulated_Data_Continuous_Scenarios/Random_Hospital/scenarios_corrected_40.txt"); tenColumns.push_back(false);
-   prefixes.push_back("simulatedDataRandomHospital_"); n_entries.push_back(500); OSM_able.push_back(true); default_THs.push_back(7200);
-   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
-   
-   paths.push_back(dir / "Simulated_Data_Continuous_Scenarios/Random_Hospital/scenarios_corrected_200.txt"); tenColumns.push_back(false);
-   prefixes.push_back("simulatedDataRandomHospital_"); n_entries.push_back(500); OSM_able.push_back(true); default_THs.push_back(7200);
-   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
-
-   paths.push_back(dir / "Simulated_Data_Continuous_Scenarios/Random_Hospital/scenarios_corrected_600.txt"); tenColumns.push_back(false);
-   prefixes.push_back("simulatedDataRandomHospital_"); n_entries.push_back(500); OSM_able.push_back(true); default_THs.push_back(7200);
-   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
-
-   paths.push_back(dir / "Simulated_Data_Rectangle/simualtedRectanglePoisson.txt"); tenColumns.push_back(true);
-   prefixes.push_back("rectanglePoisson_"); n_entries.push_back(500); OSM_able.push_back(false); default_THs.push_back(7200);
-   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
-
-   paths.push_back(dir / "Simulated_Data_Rectangle/simualtedRectangleUniform.txt"); tenColumns.push_back(true);
-   prefixes.push_back("rectangleUniform_"); n_entries.push_back(500); OSM_able.push_back(false); default_THs.push_back(7200);
-   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
-
-
-
-   // ---------
-   //instances requested by Thibaut ocupy indices 5000 - 5129:
-
-   //t2:
-   paths.push_back(dir / "Andre/scenarios_n10_t2_r11.txt"); tenColumns.push_back(false);
-   prefixes.push_back("RJ_t2_r11"); n_entries.push_back(10); OSM_able.push_back(true);
-   default_THs.push_back(2*3600);
-   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases11.txt");
-
-   paths.push_back(dir / "Andre/scenarios_n10_t2_r38.txt"); tenColumns.push_back(false);
-   prefixes.push_back("RJ_t2_r38"); n_entries.push_back(10); OSM_able.push_back(true);
-   default_THs.push_back(2*3600);
-   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases38.txt");
-
-   paths.push_back(dir / "Andre/scenarios_n10_t2_r76.txt"); tenColumns.push_back(false);
-   prefixes.push_back("RJ_t2_r76"); n_entries.push_back(10); OSM_able.push_back(true);
-   default_THs.push_back(2*3600);
-   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
-
-   //t4:
-   paths.push_back(dir / "Andre/scenarios_n10_t4_r11.txt"); tenColumns.push_back(false);
-   prefixes.push_back("RJ_t4_r11"); n_entries.push_back(10); OSM_able.push_back(true);
-   default_THs.push_back(4*3600);
-   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases11.txt");
-
-   paths.push_back(dir / "Andre/scenarios_n10_t4_r38.txt"); tenColumns.push_back(false);
-   prefixes.push_back("RJ_t4_r38"); n_entries.push_back(10); OSM_able.push_back(true);
-   default_THs.push_back(4*3600);
-   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases38.txt");
-
-   paths.push_back(dir / "Andre/scenarios_n10_t4_r76.txt"); tenColumns.push_back(false);
-   prefixes.push_back("RJ_t4_r76"); n_entries.push_back(10); OSM_able.push_back(true);
-   default_THs.push_back(4*3600);
-   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
-
-   //t6:
-   paths.push_back(dir / "Andre/scenarios_n10_t6_r11.txt"); tenColumns.push_back(false);
-   prefixes.push_back("RJ_t6_r11"); n_entries.push_back(10); OSM_able.push_back(true);
-   default_THs.push_back(6*3600);
-   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases11.txt");
-
-   paths.push_back(dir / "Andre/scenarios_n10_t6_r38.txt"); tenColumns.push_back(false);
-   prefixes.push_back("RJ_t6_r38"); n_entries.push_back(10); OSM_able.push_back(true);
-   default_THs.push_back(6*3600);
-   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases38.txt");
-
-   paths.push_back(dir / "Andre/scenarios_n10_t6_r76.txt"); tenColumns.push_back(false); //5080
-   prefixes.push_back("RJ_t6_r76"); n_entries.push_back(10); OSM_able.push_back(true);
-   default_THs.push_back(6*3600);
-   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
-
-   //t8:
-   paths.push_back(dir / "Andre/scenarios_n10_t8_r11.txt"); tenColumns.push_back(false);
-   prefixes.push_back("RJ_t8_r11"); n_entries.push_back(10); OSM_able.push_back(true);
-   default_THs.push_back(8*3600);
-   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases11.txt");
-
-   paths.push_back(dir / "Andre/scenarios_n10_t8_r38.txt"); tenColumns.push_back(false);
-   prefixes.push_back("RJ_t8_r38"); n_entries.push_back(10); OSM_able.push_back(true);
-   default_THs.push_back(8*3600);
-   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases38.txt");
-
-   paths.push_back(dir / "Andre/scenarios_n10_t8_r76.txt"); tenColumns.push_back(false);
-   prefixes.push_back("RJ_t8_r76"); n_entries.push_back(10); OSM_able.push_back(true);
-   default_THs.push_back(8*3600);
-   hosp_paths.push_back(dir / "hospitals.txt"); ws_paths.push_back( dir / "bases.txt");
-
-   assert(paths.size() == hosp_paths.size() && hosp_paths.size() == ws_paths.size());
-
-   int i_file = 0;
-   int i_position = 0;
-   int i_total = 0;
-   bool found = false;
-   while(i_total <= instance_index && i_file < n_entries.size())
+   if(setNbVehicles > 0 && setNbVehicles != problemData.NbVehicles())
    {
-      if(i_total + n_entries[i_file] <= instance_index) //next file
-      {
-         i_total += n_entries[i_file];
-         i_file++;
-      }
-      else 
-      {
-         i_position = instance_index - i_total;
-      
-         bool useTimeHorizon = false;
-         double THValue = 0.0;
-         if(timeHorizonUsage == "" || timeHorizonUsage == "default")
-         {
-            useTimeHorizon = true;
-            THValue = default_THs[i_file];
-         }
-         else if(timeHorizonUsage == "value")
-         {
-            useTimeHorizon = true;
-            THValue = timeHorizon;
-         }
-         else if(timeHorizonUsage == "infinite")
-         {
-            useTimeHorizon = false;
-            THValue = 0.0;
-         }
-         else if(timeHorizonUsage == "compute")
-         {
-            //set to default, will be overwritten during execution
-            useTimeHorizon = true;
-            THValue = default_THs[i_file];
-         }
-         else
-         {
-            throw std::invalid_argument("Invalid timeHorizonUsage argument.");
-         }
-
-
-         bool ret = ProblemData::readVincentInstance(paths[i_file].string(), hosp_paths[i_file].string(), ws_paths[i_file].string(), cleaning_path.string(), i_position, problemData, tenColumns[i_file], OSM_able[i_file] ? osmPath : "", useTimeHorizon, THValue, setNbVehicles);
-         if(ret)
-         {
-            problemData.name = prefixes[i_file] + problemData.name;
-            return true;
-         }
-         return false;
-      }
+      throw std::invalid_argument("set_nb_vehicles " + std::to_string(setNbVehicles) + " doesn't match the " + std::to_string(problemData.NbVehicles()) + " vehicles of the compiled instance");
+   }
+   if(hasTimeHorizon || timeHorizonUsage == "value" || timeHorizonUsage == "infinite")
+   {
+      cout << "WARNING: compiled instances keep the time horizon they were converted with (" << problemData.timeHorizon << "s), time_horizon_usage " << timeHorizonUsage << " and time_horizon are ignored" << endl;
    }
-
-   throw std::invalid_argument("V instance of id  " + std::to_string(instance_index) + " not found");
-   return false;
-
-
 }
 
 bool ParseCommandLine(int argc, char ** argv, Params &params, ProblemData &problemData)
 {
    string type;
    string path;
-   string v_index;
    string requests_path;
    string osmPath;
    string output_dir;
@@ -242,12 +66,13 @@ bool ParseCommandLine(int argc, char ** argv, Params &params, ProblemData &probl
       ("help", "produce help message")
 
       //input
-      ("type,t", po::value<std::string>(&type), "type of instance. Options: PDPTW, SDVRPTW, V, V10")
+      ("type,t", po::value<std::string>(&type), "type of instance. Options: PDPTW, SDVRPTW, V, V10, bin (compiled instance, see InstanceConverter)")
       ("path,p", po::value<std::string>(&path), "path of instance")
       ("requests_path", po::value<std::string>(&requests_path), "path of requests file. Only used with V instances")
-      ("v_index", po::value<std::string>(&v_index), "Index of V instance in file. Only used with V instances")
+      ("v_index", po::value<int>(), "Index of V instance in file. Only used with V instances")
       ("osmPath", po::value<std::string>(&osmPath)->default_value(""), "Optional path to Open Street Map data")
       ("instance_index", po::value<int>(), "select instance by index considering fixed order on the usual input files")
+      ("compiled_dir", po::value<string>()->default_value(""), "directory of compiled instances named <instance_index>.bin (see InstanceConverter). With instance_index, used instead of the input files when the instance is there")
       ("time_horizon_usage", po::value<string>(&timeHorizonUsage)->default_value("default"), "Should a time horizon be used? How? ('default') use predetermined default value per instance type, ('infinite') no time horizon, ('value') use value of time_horizon arg, ('compute') compute minimum required time horizon ")
       ("time_horizon", po::value<double>(), "use a time horizon of this many seconds")
       ("waitingStationPolicy", po::value<int>()->default_value(0), "which station policy to use? (0) mandatory stop at fixed station, (1) optional stop at fixed station, (2) optionalStopInClosestWaitingStation, (3) bestOptionalStop")
@@ -269,8 +94,27 @@ bool ParseCommandLine(int argc, char ** argv, Params &params, ProblemData &probl
       ("max_pricing_time", po::value<double>()->default_value(1.0e+20), "max time to spend on a single call to the pricing algorithm")
       ("max_memory", po::value<double>()->default_value(10000.0), "max memory (used by SCIP alone) in MBs.")
       ("max_pricing_memory", po::value<double>()->default_value(10000.0), "max memory used in single pricing run in MBs")
-      ("pricing_alg", po::value<int>()->default_value(2), "set pricing algorithm. (0) DAG, (1) bellman, (2) SpacedBellman, (3) SpacedBellman2, (4) bellmanWSets, (5) spacedBellmanWSets, (6) PricerTester, (7) Hybrid")
+      ("pricing_alg", po::value<int>()->default_value(2), "set pricing algorithm. (0) DAG, (1) bellman, (2) SpacedBellman, (3) SpacedBellman2, (4) bellmanWSets, (5) spacedBellmanWSets, (6) PricerTester, (7) Hybrid, (8) LabelSetting, (9) Bidirectional")
+      ("label_storage", po::value<int>()->default_value(0), "container for the labels of each request in SpacedBellman pricing. (0) multiset, (1) contiguous buckets")
       ("new_routes_per_pricing", po::value<int>()->default_value(10), "How many routes to add per pricing round?")
+      ("pricing_threads", po::value<int>()->default_value(1), "How many vehicles to price at once. (1) sequential pricing")
+      ("vehicle_classes", po::value<int>()->default_value(0), "price vehicles with same type, availability and position only once? (0) No, (1) Yes")
+      ("transition_table", po::value<int>()->default_value(0), "precompute request-to-request transitions for the pricing? (0) No, (1) Yes")
+      ("completion_bounds", po::value<int>()->default_value(0), "prune pricing labels using backward completion bounds? (0) No, (1) Yes")
+      ("completion_bound_buckets", po::value<int>()->default_value(100), "number of time buckets of the completion bounds")
+      ("bidirectional_midpoint", po::value<double>()->default_value(0.5), "fraction of the vehicle's remaining time horizon where the bidirectional pricing joins forward and backward labels")
+      ("heuristic_label_limits", po::value<string>()->default_value(""), "comma separated labels kept per request by each heuristic pricing tier, tried in order after the greedy heuristic, at most 6 tiers. Empty: greedy heuristic, then exact")
+      ("incremental_pricing", po::value<int>()->default_value(0), "re-cost the labels of the previous pricing of each vehicle before labeling from scratch? (0) No, (1) Yes")
+      ("incremental_max_changed_duals", po::value<double>()->default_value(0.25), "fraction of request duals that may change before incremental pricing is skipped")
+      ("column_pool_size", po::value<int>()->default_value(0), "routes kept in the column pool, re-priced before labeling. (0) no pool")
+      ("column_pool_max_age", po::value<int>()->default_value(50), "pricing rounds a pool route is kept without having negative reduced cost")
+      ("dual_smoothing", po::value<double>()->default_value(0.0), "Wentges smoothing factor of the pricing duals, in [0, 1). (0) price with the LP duals")
+      ("early_exit_fraction", po::value<double>()->default_value(0.0), "stop a pricing call once it has new_routes_per_pricing columns with reduced cost below -fraction * |LP objective|. (0) always price to the end")
+      ("lagrangian_bound", po::value<int>()->default_value(0), "compute the Lagrangian bound of each node in exact pricing rounds, pricing every vehicle, and prune with it? (0) No, (1) Yes")
+      ("cg_gap_tolerance", po::value<double>()->default_value(0.0), "stop column generation at a node once LP objective - Lagrangian bound <= tolerance * |LP objective|. (0) only stop when converged")
+      ("distance_precision", po::value<int>()->default_value(0), "storage of the distance matrix. (0) double, (1) float")
+      ("distance_cache", po::value<string>()->default_value(""), "directory where distance matrices are stored and reused across runs (empty: no cache)")
+      ("ng_size", po::value<int>()->default_value(0), "size of the ng-route neighbourhoods of the spacedBellman pricing, at most 64. (0) no ng-route relaxation")
       ("n_random_initial_routes", po::value<int>()->default_value(0), "Number of random routes to be added to initial solution")
       ("route_gen_seed", po::value<int>()->default_value(0), "Seed for the generation of random initial routes.")
       
@@ -288,6 +132,14 @@ bool ParseCommandLine(int argc, char ** argv, Params &params, ProblemData &probl
    }
 
    int setNbVehicles = vm["set_nb_vehicles"].as<int>();
+   ProblemData::distanceCacheDirectory = vm["distance_cache"].as<string>();
+   int distancePrecision = vm["distance_precision"].as<int>();
+   if(distancePrecision != (int) DistancePrecision::float64 && distancePrecision != (int) DistancePrecision::float32)
+   {
+      cout << "distance_precision must be 0 (double) or 1 (float)" << endl;
+      return false;
+   }
+   ProblemData::distancePrecision = (DistancePrecision) distancePrecision;
 
    bool found_instance = false;
    string error = "";
@@ -339,6 +191,12 @@ bool ParseCommandLine(int argc, char ** argv, Params &params, ProblemData &probl
             found_instance = ProblemData::readVincentInstance(vm["requests_path"].as<string>(), path + "/hospitals.txt", path + "/bases.txt", path + "/cleaning.txt", vm["v_index"].as<int>(), problemData, true, osmPath, useTimeHorizon, timeHorizon);
             
          }
+         else if (type == "bin")
+         {
+            ProblemData::readCompiledInstance(path, problemData);
+            CheckCompiledInstanceOptions(problemData, setNbVehicles, timeHorizonUsage, vm.count("time_horizon") > 0);
+            found_instance = true;
+         }
          else
          {
             problemData = ProblemData(path, type);
@@ -348,8 +206,21 @@ bool ParseCommandLine(int argc, char ** argv, Params &params, ProblemData &probl
       else if(vm.count("instance_index"))
       {
          //find V instance by "usual index". Useful for lauching several jobs via command line
-         std::cout << "osmPath:" << osmPath << std::endl;
-         found_instance = FindVInstanceByIndex(path, vm["instance_index"].as<int>(), osmPath, problemData, timeHorizonUsage, timeHorizon, setNbVehicles);
+         int instanceIndex = vm["instance_index"].as<int>();
+         string compiledDir = vm["compiled_dir"].as<string>();
+         fs::path compiledPath = fs::path(compiledDir) / (std::to_string(instanceIndex) + ".bin");
+         if(!compiledDir.empty() && fs::exists(compiledPath))
+         {
+            std::cout << "compiled instance: " << compiledPath.string() << std::endl;
+            ProblemData::readCompiledInstance(compiledPath.string(), problemData);
+            CheckCompiledInstanceOptions(problemData, setNbVehicles, timeHorizonUsage, vm.count("time_horizon") > 0);
+            found_instance = true;
+         }
+         else
+         {
+            std::cout << "osmPath:" << osmPath << std::endl;
+            found_instance = FindVInstanceByIndex(path, instanceIndex, osmPath, problemData, timeHorizonUsage, timeHorizon, setNbVehicles);
+         }
       }
    }
    catch (std::exception& e) {
@@ -361,12 +232,55 @@ bool ParseCommandLine(int argc, char ** argv, Params &params, ProblemData &probl
    }
 
    params.pricingAlgorithm = (PricingAlgorithm) vm["pricing_alg"].as<int>();
+   params.labelStorage = (LabelStorage) vm["label_storage"].as<int>();
    params.max_time =  vm["max_time"].as<double>();
    params.maxTimeSinglePricing =  vm["max_pricing_time"].as<double>();
    params.max_memory = vm["max_memory"].as<double>();
    params.maxMemorySinglePricing = vm["max_pricing_memory"].as<double>();
 
    params.newRoutesPerPricing = vm["new_routes_per_pricing"].as<int>();
+   params.pricingThreads = std::max(1, vm["pricing_threads"].as<int>());
+   params.useVehicleClasses = vm["vehicle_classes"].as<int>() == 1;
+   params.useTransitionTable = vm["transition_table"].as<int>() == 1;
+   params.useCompletionBounds = vm["completion_bounds"].as<int>() == 1;
+   params.completionBoundBuckets = vm["completion_bound_buckets"].as<int>();
+   params.bidirectionalMidpoint = std::clamp(vm["bidirectional_midpoint"].as<double>(), 0.0, 1.0);
+   params.ngNeighbourhoodSize = std::clamp(vm["ng_size"].as<int>(), 0, NgNeighbourhoods::MaxSize);
+   if(params.ngNeighbourhoodSize > 0 && params.pricingAlgorithm != PricingAlgorithm::spacedBellman)
+   {
+      cout << "ng_size is only supported by the spacedBellman pricing (pricing_alg 2)" << endl;
+      return false;
+   }
+   params.earlyExitFraction = std::max(0.0, vm["early_exit_fraction"].as<double>());
+   params.useIncrementalPricing = vm["incremental_pricing"].as<int>() == 1;
+   params.incrementalMaxChangedDuals = vm["incremental_max_changed_duals"].as<double>();
+   params.columnPoolSize = std::max(0, vm["column_pool_size"].as<int>());
+   params.columnPoolMaxAge = vm["column_pool_max_age"].as<int>();
+   params.dualSmoothing = std::clamp(vm["dual_smoothing"].as<double>(), 0.0, 0.99);
+   params.useLagrangianBound = vm["lagrangian_bound"].as<int>() == 1;
+   params.cgGapTolerance = std::max(0.0, vm["cg_gap_tolerance"].as<double>());
+
+   params.heuristicLabelLimits.clear();
+   std::stringstream labelLimits(vm["heuristic_label_limits"].as<string>());
+   for(string limit; std::getline(labelLimits, limit, ',');)
+   {
+      if(limit.empty()) continue;
+      size_t length = 0;
+      int value = 0;
+      try { value = std::stoi(limit, &length); }
+      catch(std::exception&) { length = 0; }
+      if(length == 0 || length != limit.size())
+      {
+         cout << "heuristic_label_limits must be comma separated integers, not \"" << limit << "\"" << endl;
+         return false;
+      }
+      if((int) params.heuristicLabelLimits.size() == Params::MaxHeuristicLabelLimits)
+      {
+         cout << "heuristic_label_limits takes at most " << Params::MaxHeuristicLabelLimits << " limits" << endl;
+         return false;
+      }
+      params.heuristicLabelLimits.push_back(std::max(1, value));
+   }
 
    params.nbRandomInitialRoutes = vm["n_random_initial_routes"].as<int>();
    params.route_gen_seed = vm["route_gen_seed"].as<int>();
@@ -393,6 +307,9 @@ bool ParseCommandLine(int argc, char ** argv, Params &params, ProblemData &probl
    }
    else cout << "run instance " << problemData.name << endl;
 
+   const DistanceMatrix &distances = problemData.Distances();
+   cout << "distance precision " << (int) distances.Precision() << ": " << distances.MemoryUsage() / (1024 * 1024) << " MB, max error " << distances.MaxError() << "s" << endl;
+
    params.outputDirectory = output_dir;
    params.outputSuffix = suffix;
 
@@ -4,6 +4,10 @@
 #include <assert.h>
 #include <string.h>
 #include <ctime>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 #include<unordered_set>
 
@@ -20,6 +24,10 @@
 #include "BasePricing.h"
 //#include "BellmanPricing.h"
 #include "SpacedBellmanPricing.h"
+#include "LabelSettingPricing.h"
+#include "BidirectionalPricing.h"
+#include "RouteExpander.h"
+#include "NgNeighbourhoods.h"
 //#include "SpacedBellmanPricing2.h"
 //#include "DAGPricing.h"
 //#include "HybridPricing.h"
@@ -72,6 +80,21 @@ SCIP_DECL_PRICERFREE(pricerFreeSPwCG)
       //must be called to prevent memory leak. SCIPfreeBlockMemory doesn't trigger it automatically!
       delete pricerdata->pricingAlgo;
 
+      if(pricerdata->threadPool != NULL)
+      {
+         for(int t = 0; t < pricerdata->threadPool->NbThreads(); t++)
+         {
+            delete pricerdata->workerPricingAlgos[t];
+         }
+         SCIPfreeBlockMemoryArrayNull(scip, &pricerdata->workerPricingAlgos, pricerdata->threadPool->NbThreads());
+         delete pricerdata->threadPool;
+      }
+
+      delete pricerdata->columnPool;
+      delete pricerdata->centerAlpha;
+      delete pricerdata->centerBeta;
+      delete pricerdata->rootBoundTrace;
+
       SCIPfreeBlockMemory(scip, &pricerdata);
    }
 
@@ -166,7 +189,7 @@ static bool routeContainsRequest(ProblemData *problemData, Route* route, int req
    return false;
 }
 
-static bool DoesRouteViolateBranching(SCIP* scip, ProblemData* problemData, Route* route)
+static bool DoesRouteViolateBranching(SCIP* scip, ProblemData* problemData, const Route* route)
 {
    SCIP_PROBDATA *probdata = SCIPgetProbData(scip);
    int n_vars = SCIPprobdataGetNVars(probdata);
@@ -220,10 +243,9 @@ static void buildConsideredRequestsVector(SCIP* scip, ProblemData* problemData,
    return;
 }
 
-static void buildForbiddenEdges(SCIP* scip, ProblemData* problemData, std::set<pair<int, int>> &outSet)
+//marks the request pairs forbidden by active edge branching constraints
+static void buildForbiddenEdges(SCIP* scip, ProblemData* problemData, PricingEdges &outEdges)
 {
-   outSet.clear();
-
    SCIP_PROBDATA *probdata = SCIPgetProbData(scip);
 
    const std::vector<SCIP_CONS*> *edgeBranchingConstraints = GetEdgeBranchingConstraints(probdata);
@@ -254,7 +276,7 @@ static void buildForbiddenEdges(SCIP* scip, ProblemData* problemData, std::set<p
 
       pair<int, int> edge = (*constrainedEdges)[c];
       double rhs = SCIPgetRhsLinear(scip,cons);
-      if(rhs == 0.0) outSet.insert(edge);
+      if(rhs == 0.0) outEdges.Forbid(problemData->RequestIdToIndex(edge.first), problemData->RequestIdToIndex(edge.second));
    }
 }
 
@@ -471,11 +493,327 @@ static void checkForVarRedCosts(SCIP* scip)
     }
 }
 
+//accumulates the statistics of a single pricing call
+static void logPricingCall(SCIP_PRICERDATA* pricerdata, Params* params, const PricingReturn &ret, double time)
+{
+   pricerdata->total_pricing_time += time;
+   pricerdata->total_pricing_calls += 1;
+   pricerdata->labelsPriced += ret.labelsPriced;
+   pricerdata->labelsStored += ret.labelsStored;
+   pricerdata->labelsDeleted += ret.labelsDeleted;
+   pricerdata->labelsPrunedByBound += ret.labelsPrunedByBound;
+   pricerdata->labelsReused += ret.labelsReused;
+   if(ret.incremental) pricerdata->incrementalPricingCalls++;
+   pricerdata->sumOfMaxLabelsStoredSimultaneously += ret.maxLabelsStoredSimultaneously;
+   pricerdata->sumOfMostLabelsInRequest += ret.mostLabelsInRequest;
+   pricerdata->sumOfNbConsideredRequests += ret.nbConsideredRequests;
+   pricerdata->tierTime[pricerdata->pricingTier] += time;
+   
+   if(ret.exitedEarly) pricerdata->total_pricing_early_exits++;
+   if(ret.timeout) 
+   {
+      pricerdata->total_pricing_timeouts++;
+      params->timeout = true;
+   }
+}
+
+//configures pricingAlgo for a tier of SCIP_PricerData::pricingTier
+static void setPricingTier(BasePricing* pricingAlgo, Params* params, int tier)
+{
+   int nbLimits = params->heuristicLabelLimits.size();
+   pricingAlgo->SetHeuristicPricing(tier == 0);
+   pricingAlgo->SetLabelLimit(tier >= 1 && tier <= nbLimits ? params->heuristicLabelLimits[tier - 1] : 0);
+}
+
+/*
+   groups of vehicles priced together. With params->useVehicleClasses, these are the vehicle classes of problemData, 
+   whose members only differ on their alpha dual. Otherwise, each vehicle is its own group
+*/
+static void buildVehicleGroups(Params* params, ProblemData* problemData, vector<vector<int>> &outGroups, vector<int> &outGroupOf)
+{
+   outGroups.clear();
+   outGroupOf.resize(problemData->NbVehicles());
+
+   if(params->useVehicleClasses)
+   {
+      for(int c = 0; c < problemData->NbVehicleClasses(); c++)
+      {
+         outGroups.push_back(problemData->GetVehicleClassMembers(c));
+      }
+      for(int v = 0; v < problemData->NbVehicles(); v++)
+      {
+         outGroupOf[v] = problemData->GetVehicleClass(v);
+      }
+   }
+   else
+   {
+      for(int v = 0; v < problemData->NbVehicles(); v++)
+      {
+         outGroups.push_back(vector<int>(1, v));
+         outGroupOf[v] = v;
+      }
+   }
+}
+
+//the member with the largest alpha dual has the most negative reduced costs, so its pricing finds every route useful to the group
+static int getGroupRepresentative(const vector<int> &group, const vector<double> &alpha_duals)
+{
+   int best = group[0];
+   for(int v : group)
+   {
+      if(alpha_duals[v] > alpha_duals[best]) best = v;
+   }
+   return best;
+}
+
+//reduced cost of route with the given duals, as the pricing algorithms compute it
+static double routeReducedCost(ProblemData* problemData, const Route &route, const vector<double> &alpha_duals, const vector<double> &beta_duals, const PricingEdges &edges)
+{
+   double reducedCost = route.total_lateness - alpha_duals[route.veh_index];
+   int iLast = -1;
+   for(const Vertex &vertex : route.vertices)
+   {
+      if(!problemData->IsRequest(vertex.id)) continue;
+      int iReq = problemData->RequestIdToIndex(vertex.id);
+      reducedCost -= beta_duals[iReq];
+      if(iLast != -1) reducedCost -= edges.Dual(iLast, iReq);
+      iLast = iReq;
+   }
+   return reducedCost;
+}
+
+/*
+   order in which priced routes are added to SCIP: by reduced cost, then by vertex sequence (which starts at the vehicle's initial position).
+   It doesn't depend on how the vehicles were split between pricing threads
+*/
+static bool isAddedBefore(double reducedCost1, const Route &route1, double reducedCost2, const Route &route2)
+{
+   if(reducedCost1 != reducedCost2) return reducedCost1 < reducedCost2;
+   return std::lexicographical_compare(route1.vertices.begin(), route1.vertices.end(), route2.vertices.begin(), route2.vertices.end(), 
+      [](const Vertex &a, const Vertex &b) { return a.id < b.id; });
+}
+
+/*
+   creates a variable for route, priced for vehicle iVeh with reducedCost, and copies of it for the other members of its group
+   whose reduced cost is still negative. addVar is set to true if any variable was added to SCIP.
+   Copies that don't become variables, because their reduced cost isn't negative or they already are one, go to the column pool
+
+   lpAlpha and lpBeta are NULL if the route was priced with the LP duals. Otherwise (smoothed duals), variables are only added 
+   if their reduced cost with the LP duals is negative
+*/
+static SCIP_RETCODE addPricedRoute(SCIP* scip, SCIP_PRICERDATA* pricerdata, Params* params, const vector<int> &group, int iVeh, const vector<double> &alpha_duals, double pricedReducedCost, const Route &pricedRoute, 
+   const vector<double>* lpAlpha, const vector<double>* lpBeta, const PricingEdges &edges, bool &addVar)
+{
+   ProblemData *problemData = pricerdata->problemData;
+
+   if(DoesRouteViolateBranching(scip, problemData, &pricedRoute))
+      throw std::runtime_error("Priced route violates branching rules");
+
+   assert(pricedRoute.veh_index == iVeh);
+
+   for(int member : group)
+   {
+      //routes of the group only differ on the vehicle dual
+      double reducedCost = pricedReducedCost + alpha_duals[iVeh] - alpha_duals[member];
+
+      Route route = pricedRoute;
+      if(member != iVeh)
+      {
+         //same position and availability, so arrival times and cost don't change
+         route.veh_index = member;
+         route.vertices[0] = *problemData->GetInitialPosition(member);
+      }
+
+      if(lpAlpha != NULL) reducedCost = routeReducedCost(problemData, route, *lpAlpha, *lpBeta, edges);
+
+      if(reducedCost > -params->RCEpsilon)
+      {
+         //may be useful to this member later on
+         if(pricerdata->columnPool != NULL) pricerdata->columnPool->Add(problemData, route);
+         continue;
+      }
+
+      SCIP_VAR* newVar = NULL;
+      bool ret2 = createRouteVariable(scip, params, pricerdata->conss, problemData, &route, &newVar, false, reducedCost);
+      if(ret2)
+      {
+          /* add the new variable to the pricer store */
+         SCIP_CALL( SCIPaddPricedVar(scip, newVar, 1.0) ); // 1.0 -> pricing score? The larger, the better the varible... ???
+         SCIP_CALL( SCIPreleaseVar(scip, &newVar) );
+         addVar = true;
+         pricerdata->lastSuccessfullVehicle = iVeh;
+      }
+      else if(pricerdata->columnPool != NULL)
+      {
+         //already a variable. Removable variables may be dropped by SCIP, the pool finds the route again then
+         pricerdata->columnPool->Add(problemData, route);
+      }
+   }
+
+   return SCIP_OKAY;
+}
+
+//adds the routes of a pricing call for vehicle iVeh of group, in the order of isAddedBefore. See addPricedRoute
+static SCIP_RETCODE addPricedRoutes(SCIP* scip, SCIP_PRICERDATA* pricerdata, Params* params, const vector<int> &group, int iVeh, const vector<double> &alpha_duals, const PricingReturn &ret, vector<Route> &outRoutes, 
+   const vector<double>* lpAlpha, const vector<double>* lpBeta, const PricingEdges &edges, bool &addVar)
+{
+   vector<int> order(outRoutes.size());
+   for(int r = 0; r < (int) order.size(); r++) order[r] = r;
+   std::stable_sort(order.begin(), order.end(), [&](int r1, int r2) 
+      { return isAddedBefore(ret.reducedCostPerRoute[r1], outRoutes[r1], ret.reducedCostPerRoute[r2], outRoutes[r2]); });
+
+   for(int r : order)
+   {
+      SCIP_CALL( addPricedRoute(scip, pricerdata, params, group, iVeh, alpha_duals, ret.reducedCostPerRoute[r], outRoutes[r], lpAlpha, lpBeta, edges, addVar) );
+   }
+
+   return SCIP_OKAY;
+}
+
+/*
+   creates variables for the pool routes with negative reduced cost, at most params->newRoutesPerPricing per vehicle, best first. 
+   addVar is set to true if any variable was added to SCIP
+*/
+static SCIP_RETCODE addPoolColumns(SCIP* scip, SCIP_PRICERDATA* pricerdata, Params* params, const vector<double> &alpha_duals, const vector<double> &beta_duals, const PricingEdges &edges, bool &addVar)
+{
+   ProblemData *problemData = pricerdata->problemData;
+   ColumnPool *pool = pricerdata->columnPool;
+
+   vector<pair<double, int>> candidates;
+   pool->Scan(alpha_duals, beta_duals, edges, params->RCEpsilon, candidates);
+   std::sort(candidates.begin(), candidates.end());
+
+   vector<int> addedPerVehicle(problemData->NbVehicles(), 0);
+   for(const pair<double, int> &candidate : candidates)
+   {
+      Route route = pool->GetRoute(candidate.second);
+      if(addedPerVehicle[route.veh_index] >= params->newRoutesPerPricing) continue;
+      if(DoesRouteViolateBranching(scip, problemData, &route)) continue;
+
+      //whether it is added or already a variable, it leaves the pool
+      pool->Take(candidate.second);
+
+      SCIP_VAR* newVar = NULL;
+      bool ret = createRouteVariable(scip, params, pricerdata->conss, problemData, &route, &newVar, false, candidate.first);
+      if(ret)
+      {
+         SCIP_CALL( SCIPaddPricedVar(scip, newVar, 1.0) );
+         SCIP_CALL( SCIPreleaseVar(scip, &newVar) );
+         addedPerVehicle[route.veh_index]++;
+         pricerdata->poolColumnsAdded++;
+         addVar = true;
+      }
+   }
+
+   return SCIP_OKAY;
+}
+
+//moves duals towards the stability center: smoothing * center + (1 - smoothing) * duals
+static void smoothDuals(double smoothing, const vector<double> &center, vector<double> &duals)
+{
+   for(int i = 0; i < (int) duals.size(); i++)
+   {
+      duals[i] = smoothing * center[i] + (1.0 - smoothing) * duals[i];
+   }
+}
+
+/*
+   dual objective of the master at alpha_duals and beta_duals, with the edge branching constraints at their LP duals (edgeObjective).
+   With the most negative reduced cost of each vehicle at those duals added (see addLagrangianTerms), it is a Lagrangian bound of the node.
+   Vehicle constraints are 0 <= sum <= 1, so only their negative duals count, and each request's y variable takes its bound that 
+   minimizes its reduced cost
+*/
+static double dualObjective(SCIP* scip, ProblemData* problemData, const vector<double> &alpha_duals, const vector<double> &beta_duals, double edgeObjective)
+{
+   SCIP_VAR** vars = SCIPprobdataGetVars(SCIPgetProbData(scip));
+
+   double objective = edgeObjective;
+   for(int i = 0; i < problemData->NbVehicles(); i++) objective += std::min(0.0, alpha_duals[i]);
+   for(int i = 0; i < problemData->NbRequests(); i++)
+   {
+      objective += beta_duals[i];
+
+      //requests that must be serviced have their y variable fixed to 0, outside of the request constraint
+      if(problemData->GetRequestByIndex(i)->non_service_penalty == std::numeric_limits<double>::infinity()) continue;
+      double reducedCost = SCIPvarGetObj(vars[i]) - beta_duals[i];
+      objective += reducedCost * (reducedCost < 0.0 ? SCIPvarGetUbLocal(vars[i]) : SCIPvarGetLbLocal(vars[i]));
+   }
+   return objective;
+}
+
+//while the root node is being solved, the totals so far are the totals of the root
+static void logRootProgress(SCIP* scip, SCIP_PRICERDATA* pricerdata)
+{
+   if(SCIPgetDepth(scip) != 0) return;
+   pricerdata->rootPricingCalls = pricerdata->total_pricing_calls;
+   pricerdata->rootPricingTime = pricerdata->total_pricing_time;
+   pricerdata->rootTime = SCIPgetSolvingTime(scip);
+}
+
+/*
+   adds the most negative reduced cost of each member of group, or 0 if it has none, to lagrangianSum. 
+   Members only differ on their alpha dual, so theirs follow from the one of the representative iVeh
+*/
+static void addLagrangianTerms(const vector<int> &group, int iVeh, const vector<double> &alpha_duals, const PricingReturn &ret, double &lagrangianSum)
+{
+   double bestReducedCost = 0.0;
+   if(ret.status == PricingReturnStatus::OK && !ret.reducedCostPerRoute.empty())
+   {
+      bestReducedCost = *std::min_element(ret.reducedCostPerRoute.begin(), ret.reducedCostPerRoute.end());
+   }
+
+   for(int member : group)
+   {
+      lagrangianSum += std::min(0.0, bestReducedCost + alpha_duals[iVeh] - alpha_duals[member]);
+   }
+}
+
+//only rounds that priced every vehicle exactly, to the end, bound their reduced costs
+static bool boundsReducedCost(const PricingReturn &ret)
+{
+   return !ret.timeout && !ret.exitedEarly && !ret.incremental && ret.labelsPrunedByBound == 0;
+}
+
+/*
+   passes the Lagrangian bound to SCIP, which prunes the node once it reaches the cutoff bound.
+   If columns were added but the bound is within Params::cgGapTolerance of the LP objective, column generation stops there
+*/
+static SCIP_RETCODE updateLagrangianBound(SCIP* scip, SCIP_PRICERDATA* pricerdata, Params* params, double lagrangianSum, bool addedColumns, SCIP_Real* lowerbound, SCIP_Bool* stopearly)
+{
+   double lpObjective = SCIPgetLPObjval(scip);
+   /*
+      pricing ignores reduced costs above -RCEpsilon, and only replaces a column by one more than RCEpsilon better, so each vehicle's 
+      most negative one may be that much below the one summed. Dominance has no epsilon in these rounds (see SetExactReducedCosts), 
+      which would add up along a route
+   */
+   double bound = lpObjective + lagrangianSum - pricerdata->problemData->NbVehicles() * params->RCEpsilon;
+   *lowerbound = MAX(*lowerbound, bound);
+   pricerdata->lagrangianBounds++;
+
+   if(SCIPgetDepth(scip) == 0 && bound > pricerdata->rootBestBound)
+   {
+      pricerdata->rootBestBound = bound;
+      pricerdata->rootBoundTrace->push_back(SCIPgetSolvingTime(scip));
+      pricerdata->rootBoundTrace->push_back(bound);
+      pricerdata->rootBoundTrace->push_back(lpObjective);
+   }
+
+   if(addedColumns && params->cgGapTolerance > 0.0 && lpObjective - bound <= params->cgGapTolerance * std::abs(lpObjective))
+   {
+      *stopearly = TRUE;
+      pricerdata->cgEarlyStops++;
+   }
+
+   return SCIP_OKAY;
+}
+
 static
 SCIP_RETCODE DoPricing(
    SCIP*                 scip,               /**< SCIP data structure */
    SCIP_PRICER*          pricer,             /**< pricer */
    SCIP_Bool             farkas,               /**< TRUE: Farkas pricing; FALSE: Redcost pricing */
+   SCIP_Real*            lowerbound,         /**< Lagrangian bound of the node, NULL in Farkas pricing */
+   SCIP_Bool*            stopearly,          /**< NULL in Farkas pricing */
    SCIP_RESULT* result
 )
 { 
@@ -659,7 +997,10 @@ SCIP_RETCODE DoPricing(
    const std::vector<SCIP_CONS*> *edgeBranchingConstraints = GetEdgeBranchingConstraints(probdata);
    const std::vector<pair<int, int>> *constrainedEdges = GetConstrainedEdges(probdata);
 
-   std::map<pair<int, int>, double> edgeDuals;
+   //forbidden edges and edge duals of this node, by request index. Shared by every pricing call below
+   PricingEdges edges(problemData->NbRequests());
+   //part of the dual objective of the edge branching constraints, which are equalities. Their duals are never smoothed
+   double edgeObjective = 0.0;
    for( int c = 0; c < (*edgeBranchingConstraints).size(); ++c )
    {
       assert(params->useBranchingOnEdges);
@@ -686,7 +1027,8 @@ SCIP_RETCODE DoPricing(
 
       //std::cout << "edge(" << edge.first << " , " << edge.second << ") set to: " << lhs << " , " << rhs <<  " dual: " << dual << std::endl;
 
-      edgeDuals[edge] = dual;
+      edges.SetDual(reqIndex1, reqIndex2, dual);
+      edgeObjective += rhs * dual;
    }
 
    // for(int i = 0; i < alpha_duals.size(); i++)
@@ -702,87 +1044,255 @@ SCIP_RETCODE DoPricing(
    buildConsideredRequestsVector(scip, problemData, consideredRequests);
 
 
+   //vehicles with the same pricing problem are priced once per group
+   vector<vector<int>> vehicleGroups;
+   vector<int> vehicleGroupOf;
+   buildVehicleGroups(params, problemData, vehicleGroups, vehicleGroupOf);
+   int nbGroups = vehicleGroups.size();
+
+   buildForbiddenEdges(scip, problemData, edges);
+
+   //routes priced earlier may already have negative reduced cost. If so, labeling waits for the next round
+   if(pricerdata->columnPool != NULL && !farkas)
+   {
+      SCIP_CALL( addPoolColumns(scip, pricerdata, params, alpha_duals, beta_duals, edges, addVar) );
+      if(addVar)
+      {
+         pricerdata->poolRounds++;
+         logRootProgress(scip, pricerdata);
+         (*result) = SCIP_SUCCESS;
+         return SCIP_OKAY;
+      }
+   }
+
+   //columns this good are enough to stop labeling. Farkas pricing always runs to the end
+   double earlyExitReducedCost = -HUGE_VAL;
+   if(!farkas && params->earlyExitFraction > 0.0) earlyExitReducedCost = -params->earlyExitFraction * std::abs(SCIPgetLPObjval(scip));
+
+   /*
+      Wentges smoothing: price with duals between the stability center and the LP duals, which oscillate much less.
+      The center starts at the LP duals of the node's first round. Each exact round, smoothed or not, computes the Lagrangian bound at
+      the duals it priced with, and the center moves there whenever that bound beats the center's. Farkas duals are never smoothed
+   */
+   bool stabilize = !farkas && params->dualSmoothing > 0.0;
+   if(stabilize && pricerdata->centerNode != SCIPnodeGetNumber(SCIPgetCurrentNode(scip)))
+   {
+      //bounds of other nodes don't hold here
+      pricerdata->centerAlpha->clear();
+      pricerdata->centerBeta->clear();
+      pricerdata->centerBound = -HUGE_VAL;
+      pricerdata->centerNode = SCIPnodeGetNumber(SCIPgetCurrentNode(scip));
+   }
+   bool smoothed = stabilize && !pricerdata->centerAlpha->empty();
+   vector<double> lpAlpha, lpBeta;
+   if(smoothed)
+   {
+      lpAlpha = alpha_duals;
+      lpBeta = beta_duals;
+      smoothDuals(params->dualSmoothing, *pricerdata->centerAlpha, alpha_duals);
+      smoothDuals(params->dualSmoothing, *pricerdata->centerBeta, beta_duals);
+   }
+
+   //algorithms without heuristic modes go straight to exact pricing
+   int exactTier = params->heuristicLabelLimits.size() + 1;
+   int firstTier = pricerdata->pricingAlgo->HasHeuristicModes() ? 0 : exactTier;
+   pricerdata->pricingTier = firstTier;
+
+   /*
+      Lagrangian bound: LP objective + sum over vehicles of min(0, most negative reduced cost), since each vehicle takes at most one route.
+      Only exact pricing gives those, and only if every vehicle is priced, so such rounds don't stop at the first vehicle with columns.
+      At smoothed duals, the dual objective there (see dualObjective) takes the place of the LP objective. Only bounds at the LP duals
+      go to SCIP, dual smoothing uses both to move its center
+   */
+   bool boundRound;
+   bool boundValid;
+   double lagrangianSum;
+
    PRICING_START:
+   pricerdata->tierRounds[pricerdata->pricingTier]++;
+   boundRound = !farkas && (params->useLagrangianBound || stabilize) && pricerdata->pricingTier == exactTier;
+   boundValid = true;
+   lagrangianSum = 0.0;
    //prices out all vehicles:
    //to-do maybe randomize order?
-   int iVeh = pricerdata->lastSuccessfullVehicle;
-   int nbVehiclesTried = 0;
-   while(!addVar && nbVehiclesTried < problemData->NbVehicles())
+   int iGroup = vehicleGroupOf[pricerdata->lastSuccessfullVehicle];
+   int nbGroupsTried = 0;
+
+   if(pricerdata->threadPool == NULL)
    {
-      if(params->Timeout())
+      while((!addVar || boundRound) && nbGroupsTried < nbGroups)
       {
-         params->timeout = true;
-         break;
-      }
-      vector<Route> outRoutes;
+         if(params->Timeout())
+         {
+            params->timeout = true;
+            break;
+         }
+         vector<Route> outRoutes;
 
-      pricerdata->pricingAlgo->SetMaxTime(params->maxTimeSinglePricing);
-      pricerdata->pricingAlgo->SetMaxMemory(params->maxMemorySinglePricing);
+         pricerdata->pricingAlgo->SetMaxTime(params->maxTimeSinglePricing);
+         pricerdata->pricingAlgo->SetMaxMemory(params->maxMemorySinglePricing);
+         pricerdata->pricingAlgo->SetEarlyExitReducedCost(boundRound ? -HUGE_VAL : earlyExitReducedCost);
+         pricerdata->pricingAlgo->SetExactReducedCosts(boundRound);
 
-      //temp gambiarra
-      SpacedBellmanPricing *sbp = (SpacedBellmanPricing*) pricerdata->pricingAlgo;
-      sbp->SetHeuristicPricing(pricerdata->heuristicPricing);
+         setPricingTier(pricerdata->pricingAlgo, params, pricerdata->pricingTier);
 
-      set<pair<int, int>> forbiddenEdges;
-      buildForbiddenEdges(scip, problemData, forbiddenEdges);
-      
-      std::clock_t alg_start = std::clock();
-      PricingReturn ret = pricerdata->pricingAlgo->Price(iVeh, params->newRoutesPerPricing, alpha_duals, beta_duals, outRoutes, consideredRequests, forbiddenEdges, edgeDuals);
-      std::clock_t alg_end = std::clock();
-      double total_time = ((double)(alg_end - alg_start)) / CLOCKS_PER_SEC; //seconds
-      pricerdata->total_pricing_time += total_time;
-      pricerdata->total_pricing_calls += 1;
-      pricerdata->labelsPriced += ret.labelsPriced;
-      pricerdata->labelsStored += ret.labelsStored;
-      pricerdata->labelsDeleted += ret.labelsDeleted;
-      pricerdata->sumOfMaxLabelsStoredSimultaneously += ret.maxLabelsStoredSimultaneously;
-      pricerdata->sumOfMostLabelsInRequest += ret.mostLabelsInRequest;
-      pricerdata->sumOfNbConsideredRequests += ret.nbConsideredRequests;
-      
-      if(ret.timeout) 
-      {
-         pricerdata->total_pricing_timeouts++;
-         params->timeout = true;
-      }
+         int iVeh = getGroupRepresentative(vehicleGroups[iGroup], alpha_duals);
+         
+         std::clock_t alg_start = std::clock();
+         PricingReturn ret = pricerdata->pricingAlgo->Price(iVeh, params->newRoutesPerPricing, alpha_duals, beta_duals, outRoutes, consideredRequests, edges);
+         std::clock_t alg_end = std::clock();
+         double total_time = ((double)(alg_end - alg_start)) / CLOCKS_PER_SEC; //seconds
+         logPricingCall(pricerdata, params, ret, total_time);
+
+         if(ret.status == PricingReturnStatus::OK)
+         {
+            SCIP_CALL( addPricedRoutes(scip, pricerdata, params, vehicleGroups[iGroup], iVeh, alpha_duals, ret, outRoutes, 
+               smoothed ? &lpAlpha : NULL, smoothed ? &lpBeta : NULL, edges, addVar) );
+         }
+
+         if(boundRound)
+         {
+            addLagrangianTerms(vehicleGroups[iGroup], iVeh, alpha_duals, ret, lagrangianSum);
+            boundValid = boundValid && boundsReducedCost(ret);
+         }
 
-      if(ret.status == PricingReturnStatus::OK)
+         if(ret.status != PricingReturnStatus::OK || boundRound)
+         {
+            iGroup = (iGroup + 1) % nbGroups;
+            nbGroupsTried++;
+         }
+      }
+   }
+   else
+   {
+      //prices one batch of consecutive groups at a time, one group per thread
+      int nbThreads = pricerdata->threadPool->NbThreads();
+      while((!addVar || boundRound) && nbGroupsTried < nbGroups)
       {
-         for(int r = 0; r < outRoutes.size(); r++)
+         if(params->Timeout())
+         {
+            params->timeout = true;
+            break;
+         }
+
+         int batchSize = std::min(nbThreads, nbGroups - nbGroupsTried);
+         vector<vector<Route>> batchRoutes(batchSize);
+         vector<PricingReturn> batchRets(batchSize);
+         vector<double> batchTimes(batchSize);
+         vector<int> batchVehicles(batchSize);
+         for(int b = 0; b < batchSize; b++)
+         {
+            batchVehicles[b] = getGroupRepresentative(vehicleGroups[(iGroup + b) % nbGroups], alpha_duals);
+         }
+
+         pricerdata->threadPool->Run(batchSize, [&](int worker, int b)
          {
+            BasePricing* pricingAlgo = pricerdata->workerPricingAlgos[worker];
+            pricingAlgo->SetMaxTime(params->maxTimeSinglePricing);
+            pricingAlgo->SetMaxMemory(params->maxMemorySinglePricing);
+            pricingAlgo->SetEarlyExitReducedCost(boundRound ? -HUGE_VAL : earlyExitReducedCost);
+            pricingAlgo->SetExactReducedCosts(boundRound);
+            setPricingTier(pricingAlgo, params, pricerdata->pricingTier);
+
+            //std::clock measures the cpu time of the whole process, which would count the other threads too
+            auto alg_start = std::chrono::steady_clock::now();
+            batchRets[b] = pricingAlgo->Price(batchVehicles[b], params->newRoutesPerPricing, alpha_duals, beta_duals, batchRoutes[b], consideredRequests, edges);
+            auto alg_end = std::chrono::steady_clock::now();
+            batchTimes[b] = std::chrono::duration<double>(alg_end - alg_start).count();
+         });
+
+         //routes of the whole batch, (batch index, route index), merged in the order of isAddedBefore so that the columns don't depend on which thread finished first
+         vector<pair<int, int>> batchOrder;
+         for(int b = 0; b < batchSize; b++)
+         {
+            logPricingCall(pricerdata, params, batchRets[b], batchTimes[b]);
 
-            if(DoesRouteViolateBranching(scip, problemData, &outRoutes[r]))
-               throw std::runtime_error("Priced route violates branching rules");
+            const vector<int> &group = vehicleGroups[(iGroup + b) % nbGroups];
+            if(boundRound)
+            {
+               addLagrangianTerms(group, batchVehicles[b], alpha_duals, batchRets[b], lagrangianSum);
+               boundValid = boundValid && boundsReducedCost(batchRets[b]);
+            }
 
-            assert(!DoesRouteViolateBranching(scip, problemData, &outRoutes[r]));
+            if(batchRets[b].status != PricingReturnStatus::OK) continue;
+            for(int r = 0; r < (int) batchRoutes[b].size(); r++) batchOrder.push_back(pair<int, int>(b, r));
+         }
+         std::stable_sort(batchOrder.begin(), batchOrder.end(), [&](const pair<int, int> &k1, const pair<int, int> &k2) 
+         { 
+            return isAddedBefore(batchRets[k1.first].reducedCostPerRoute[k1.second], batchRoutes[k1.first][k1.second], 
+               batchRets[k2.first].reducedCostPerRoute[k2.second], batchRoutes[k2.first][k2.second]); 
+         });
+
+         vector<bool> addedForGroup(batchSize, false);
+         for(const pair<int, int> &k : batchOrder)
+         {
+            bool added = false;
+            SCIP_CALL( addPricedRoute(scip, pricerdata, params, vehicleGroups[(iGroup + k.first) % nbGroups], batchVehicles[k.first], alpha_duals, batchRets[k.first].reducedCostPerRoute[k.second], 
+               batchRoutes[k.first][k.second], smoothed ? &lpAlpha : NULL, smoothed ? &lpBeta : NULL, edges, added) );
+            addedForGroup[k.first] = addedForGroup[k.first] || added;
+            addVar = addVar || added;
+         }
 
-            assert(outRoutes[r].veh_index == iVeh);
-            SCIP_VAR* newVar = NULL;
-            bool ret2 = createRouteVariable(scip, params, pricerdata->conss, problemData, &outRoutes[r], &newVar, false, ret.reducedCostPerRoute[r]);
-            if(ret2)
+         //the next round starts from the first group of the batch that got columns
+         for(int b = 0; b < batchSize; b++)
+         {
+            if(addedForGroup[b])
             {
-                /* add the new variable to the pricer store */
-               SCIP_CALL( SCIPaddPricedVar(scip, newVar, 1.0) ); // 1.0 -> pricing score? The larger, the better the varible... ???
-               SCIP_CALL( SCIPreleaseVar(scip, &newVar) );
-               addVar = true;
-               pricerdata->lastSuccessfullVehicle = iVeh;
+               pricerdata->lastSuccessfullVehicle = batchVehicles[b];
+               break;
             }
          }
+         if(!addVar || boundRound)
+         {
+            iGroup = (iGroup + batchSize) % nbGroups;
+            nbGroupsTried += batchSize;
+         }
       }
-      else
+   }
+
+   if(addVar) pricerdata->tierHits[pricerdata->pricingTier]++;
+
+   if(boundRound && boundValid && nbGroupsTried >= nbGroups)
+   {
+      if(params->useLagrangianBound && !smoothed) SCIP_CALL( updateLagrangianBound(scip, pricerdata, params, lagrangianSum, addVar, lowerbound, stopearly) );
+
+      double bound = lagrangianSum + (smoothed ? dualObjective(scip, problemData, alpha_duals, beta_duals, edgeObjective) : SCIPgetLPObjval(scip));
+      if(stabilize && bound > pricerdata->centerBound)
       {
-         iVeh = (iVeh + 1) % problemData->NbVehicles();
-         nbVehiclesTried++;
+         *pricerdata->centerAlpha = alpha_duals;
+         *pricerdata->centerBeta = beta_duals;
+         pricerdata->centerBound = bound;
       }
    }
 
-   if(!addVar && pricerdata->heuristicPricing && !params->timeout)
+   if(!addVar && pricerdata->pricingTier < exactTier && !params->timeout)
    {
-      //if we had been doing heuristic pricing until now, but every vehicle has just failed, disable heuristic pricing and try again
-      std::cout << "switch to exact pricing" << std::endl;
-      pricerdata->heuristicPricing = false;
+      //every vehicle has just failed with this tier, try the next one
+      pricerdata->pricingTier++;
+      if(pricerdata->pricingTier == exactTier) std::cout << "switch to exact pricing" << std::endl;
       goto PRICING_START;
    }
 
+   if(!addVar && smoothed && !params->timeout)
+   {
+      //mispricing: nothing useful at the LP duals was found. Price them directly, so failing still proves no column is missing
+      pricerdata->mispricings++;
+      alpha_duals = lpAlpha;
+      beta_duals = lpBeta;
+      smoothed = false;
+      pricerdata->pricingTier = firstTier;
+      goto PRICING_START;
+   }
+
+   if(stabilize && pricerdata->centerAlpha->empty())
+   {
+      //first round of the node, never smoothed
+      *pricerdata->centerAlpha = alpha_duals;
+      *pricerdata->centerBeta = beta_duals;
+   }
+
+   logRootProgress(scip, pricerdata);
+
    //result is success regardless of wether vars were added or not
    (*result) = SCIP_SUCCESS;
    return SCIP_OKAY;
@@ -793,7 +1303,7 @@ SCIP_RETCODE DoPricing(
 static
 SCIP_DECL_PRICERREDCOST(pricerRedcostSPwCG)
 {  /*lint --e{715}*/
-   return DoPricing(scip, pricer, FALSE, result);
+   return DoPricing(scip, pricer, FALSE, lowerbound, stopearly, result);
 }
 
 /** farkas pricing method of variable pricer for infeasible LPs */
@@ -801,7 +1311,7 @@ SCIP_DECL_PRICERREDCOST(pricerRedcostSPwCG)
 static
 SCIP_DECL_PRICERFARKAS(pricerFarkasBinpacking)
 {  
-   return DoPricing(scip, pricer, TRUE, result);
+   return DoPricing(scip, pricer, TRUE, NULL, NULL, result);
 }
 
 /**@} */
@@ -824,18 +1334,46 @@ SCIP_RETCODE SCIPincludePricerSPwCG(
    pricerdata->conss = NULL;
    pricerdata->params = NULL;
    pricerdata->problemData = NULL;
-   pricerdata->heuristicPricing = true;
+   pricerdata->pricingAlgo = NULL;
+   pricerdata->threadPool = NULL;
+   pricerdata->workerPricingAlgos = NULL;
+   pricerdata->columnPool = NULL;
+   pricerdata->centerAlpha = new vector<double>();
+   pricerdata->centerBeta = new vector<double>();
+   pricerdata->centerBound = -HUGE_VAL;
+   pricerdata->centerNode = -1;
+   pricerdata->rootBestBound = -HUGE_VAL;
+   pricerdata->rootBoundTrace = new vector<double>();
+   pricerdata->pricingTier = 0;
    pricerdata->lastSuccessfullVehicle = 0;
    //pricerdata->pricingAlgo;
    pricerdata->total_pricing_time = 0.0;
    pricerdata->total_pricing_calls = 0;
    pricerdata->total_pricing_timeouts = 0;
+   pricerdata->total_pricing_early_exits = 0;
    pricerdata->labelsPriced = 0;
    pricerdata->labelsStored = 0;
    pricerdata->labelsDeleted = 0;
+   pricerdata->labelsPrunedByBound = 0;
+   pricerdata->labelsReused = 0;
+   pricerdata->incrementalPricingCalls = 0;
+   pricerdata->poolRounds = 0;
+   pricerdata->poolColumnsAdded = 0;
+   pricerdata->mispricings = 0;
+   pricerdata->rootPricingCalls = 0;
+   pricerdata->rootPricingTime = 0.0;
+   pricerdata->rootTime = 0.0;
+   pricerdata->lagrangianBounds = 0;
+   pricerdata->cgEarlyStops = 0;
    pricerdata->sumOfMaxLabelsStoredSimultaneously = 0;
    pricerdata->sumOfMostLabelsInRequest = 0;
    pricerdata->sumOfNbConsideredRequests = 0;
+   for(int t = 0; t < MAX_PRICING_TIERS; t++)
+   {
+      pricerdata->tierRounds[t] = 0;
+      pricerdata->tierHits[t] = 0;
+      pricerdata->tierTime[t] = 0.0;
+   }
 
 
    
@@ -854,6 +1392,28 @@ SCIP_RETCODE SCIPincludePricerSPwCG(
    return SCIP_OKAY;
 }
 
+//returns NULL if params->pricingAlgorithm is not supported anymore
+static BasePricing* createPricingAlgo(Params* params, ProblemData* problemData)
+{
+   if(params->pricingAlgorithm == PricingAlgorithm::spacedBellman && params->labelStorage == LabelStorage::multiset)
+   {
+      return new SpacedBellmanPricing<MultisetLabelStore>(params, problemData);
+   }
+   else if(params->pricingAlgorithm == PricingAlgorithm::spacedBellman && params->labelStorage == LabelStorage::bucket)
+   {
+      return new SpacedBellmanPricing<BucketLabelStore>(params, problemData);
+   }
+   else if(params->pricingAlgorithm == PricingAlgorithm::labelSetting)
+   {
+      return new LabelSettingPricing(params, problemData);
+   }
+   else if(params->pricingAlgorithm == PricingAlgorithm::bidirectional)
+   {
+      return new BidirectionalPricing(params, problemData);
+   }
+   return NULL;
+}
+
 /** added problem specific data to pricer and activates pricer */
 SCIP_RETCODE SCIPpricerSPwCGActivate(
    SCIP*                 scip,               /**< SCIP data structure */
@@ -881,17 +1441,40 @@ SCIP_RETCODE SCIPpricerSPwCGActivate(
    pricerdata->problemData = problemData;
 
 
-   if(params->pricingAlgorithm == PricingAlgorithm::spacedBellman)
+   //built here since the waiting station policy and rerouting are only set after the instance is loaded
+   if(params->useTransitionTable)
    {
-      auto sbp = new SpacedBellmanPricing(params, pricerdata->problemData);
-      pricerdata->pricingAlgo = sbp;
+      problemData->SetTransitionTable(TransitionTable::Build(problemData));
    }
-   else
+
+   if(params->ngNeighbourhoodSize > 0)
+   {
+      problemData->SetNgNeighbourhoods(NgNeighbourhoods::Build(problemData, params->ngNeighbourhoodSize));
+   }
+
+   pricerdata->pricingAlgo = createPricingAlgo(params, problemData);
+   if(pricerdata->pricingAlgo == NULL)
    {
       std::cerr << "Pricing algorithm no longer used " << (int) params->pricingAlgorithm << std::endl;
       return SCIP_ERROR;
    }
 
+   //each thread gets its own pricing algorithm, since they keep state during Price()
+   if(params->pricingThreads > 1)
+   {
+      pricerdata->threadPool = new PricingThreadPool(params->pricingThreads);
+      SCIP_CALL( SCIPallocBlockMemoryArray(scip, &pricerdata->workerPricingAlgos, params->pricingThreads) );
+      for(int t = 0; t < params->pricingThreads; t++)
+      {
+         pricerdata->workerPricingAlgos[t] = createPricingAlgo(params, problemData);
+      }
+   }
+
+
+   if(params->columnPoolSize > 0)
+   {
+      pricerdata->columnPool = new ColumnPool(params->columnPoolSize, params->columnPoolMaxAge);
+   }
 
    /* copy arrays */
    SCIP_CALL( SCIPduplicateBlockMemoryArray(scip, &pricerdata->conss, conss, ncons(problemData)) );
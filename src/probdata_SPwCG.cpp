@@ -776,12 +776,32 @@ ExecutionSummary GetExecutionSummary(SCIP *scip)
    summary.total_pricing_time = pricerdata->total_pricing_time;
    summary.total_pricing_calls = pricerdata->total_pricing_calls;
    summary.total_pricing_timeouts = pricerdata->total_pricing_timeouts;
+   summary.total_pricing_early_exits = pricerdata->total_pricing_early_exits;
    summary.totalLabelsPriced = pricerdata->labelsPriced;
    summary.totalLabelsStored = pricerdata->labelsStored;
    summary.totalLabelsDeleted = pricerdata->labelsDeleted;
+   summary.totalLabelsPrunedByBound = pricerdata->labelsPrunedByBound;
+   summary.totalLabelsReused = pricerdata->labelsReused;
+   summary.incrementalPricingCalls = pricerdata->incrementalPricingCalls;
+   summary.poolRounds = pricerdata->poolRounds;
+   summary.poolColumnsAdded = pricerdata->poolColumnsAdded;
+   summary.mispricings = pricerdata->mispricings;
+   summary.rootPricingCalls = pricerdata->rootPricingCalls;
+   summary.rootPricingTime = pricerdata->rootPricingTime;
+   summary.rootTime = pricerdata->rootTime;
+   summary.lagrangianBounds = pricerdata->lagrangianBounds;
+   summary.cgEarlyStops = pricerdata->cgEarlyStops;
+   summary.rootBoundTrace = *pricerdata->rootBoundTrace;
    summary.sumOfMaxLabelsStoredSimultaneously = pricerdata->sumOfMaxLabelsStoredSimultaneously;
    summary.sumOfMostLabelsInRequest = pricerdata->sumOfMostLabelsInRequest;
    summary.sumOfNbConsideredRequests = pricerdata->sumOfNbConsideredRequests;
+   summary.nbPricingTiers = pricerdata->params != NULL ? pricerdata->params->heuristicLabelLimits.size() + 2 : 0;
+   for(int t = 0; t < summary.nbPricingTiers; t++)
+   {
+      summary.tierRounds[t] = pricerdata->tierRounds[t];
+      summary.tierHits[t] = pricerdata->tierHits[t];
+      summary.tierTime[t] = pricerdata->tierTime[t];
+   }
    
    summary.timesBranchedWithRule[0] = probdata->timesBranchedWithRule[0];
    summary.timesBranchedWithRule[1] = probdata->timesBranchedWithRule[1];